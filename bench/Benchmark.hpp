@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One run of a benchmark with a given number of entities
+ *
+ * The benchmark function prepares everything it needs and then passes the part that is measured to Measure. The
+ * function is called once per sample, so every sample starts from the same state.
+ *
+ */
+struct BenchmarkRun
+{
+	/**
+	 * @brief Time the given function once
+	 *
+	 * @tparam Func Type of the function
+	 * @param func Function that does the measured work
+	 */
+	template <typename Func>
+	void Measure(Func&& func)
+	{
+		auto start = std::chrono::steady_clock::now();
+		func();
+		seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	/**
+	 * @brief Number of entities the benchmark works on
+	 *
+	 */
+	size_t size;
+
+	/**
+	 * @brief Measured time of this run in seconds
+	 *
+	 */
+	double seconds { 0 };
+};
+
+/**
+ * @brief Benchmark that is registered by constructing a static instance of it, like a test case
+ *
+ */
+struct Benchmark
+{
+	/**
+	 * @brief Construct a new Benchmark object and register it
+	 *
+	 * @param name Name of the benchmark, unique together with the size
+	 * @param func Function that runs the benchmark once
+	 */
+	Benchmark(const std::string& name, std::function<void(BenchmarkRun&)> func) :
+		name(name),
+		func(func)
+	{
+		All().push_back(this);
+	}
+
+	/**
+	 * @brief Get every registered benchmark
+	 *
+	 * @return std::vector<Benchmark*>& Benchmarks in the order in which they were registered
+	 */
+	static std::vector<Benchmark*>& All()
+	{
+		static std::vector<Benchmark*> benchmarks;
+		return benchmarks;
+	}
+
+	/**
+	 * @brief Name of the benchmark
+	 *
+	 */
+	std::string name;
+
+	/**
+	 * @brief Function that runs the benchmark once
+	 *
+	 */
+	std::function<void(BenchmarkRun&)> func;
+};
+
+/**
+ * @brief Result of a benchmark with one number of entities
+ *
+ */
+struct BenchmarkResult
+{
+	/**
+	 * @brief Name of the benchmark
+	 *
+	 */
+	std::string name;
+
+	/**
+	 * @brief Number of entities
+	 *
+	 */
+	size_t size;
+
+	/**
+	 * @brief Median time of a sample in nanoseconds per entity
+	 *
+	 */
+	double median;
+
+	/**
+	 * @brief Fastest sample in nanoseconds per entity
+	 *
+	 */
+	double min;
+};
+
+/**
+ * @brief Run a benchmark and collect its samples
+ *
+ * @param benchmark Benchmark to run
+ * @param size Number of entities
+ * @param samples Number of times the benchmark is measured
+ * @return BenchmarkResult Median and fastest time per entity
+ */
+inline BenchmarkResult RunBenchmark(const Benchmark& benchmark, size_t size, int samples)
+{
+	// The first run only warms up caches and allocator, it is not counted
+	std::vector<double> times;
+	for (int sample = -1; sample < samples; sample++)
+	{
+		BenchmarkRun run;
+		run.size = size;
+		benchmark.func(run);
+		if (sample >= 0)
+		{
+			times.push_back(run.seconds * 1e9 / double(std::max<size_t>(size, 1)));
+		}
+	}
+	std::sort(times.begin(), times.end());
+	return BenchmarkResult { benchmark.name, size, times[times.size() / 2], times.front() };
+}
+
+/**
+ * @brief Keep the compiler from removing a computation whose result is not used
+ *
+ * @tparam T Type of the result
+ * @param value Result
+ */
+template <typename T>
+inline void KeepResult(const T& value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
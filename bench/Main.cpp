@@ -0,0 +1,227 @@
+#include "Arguments.hpp"
+#include "Benchmark.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Counter of components
+ *
+ */
+int s_componentCounter = 0;
+
+/**
+ * @brief Read the results of an earlier run from a CSV file that was written with --csv
+ *
+ * @param path Path of the file
+ * @param baseline Median time per entity of every benchmark and size
+ * @return bool False if the file could not be read or a line is malformed, which is reported with its line number
+ */
+bool ReadBaseline(const std::string& path, std::map<std::pair<std::string, size_t>, double>& baseline)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		return false;
+	}
+
+	// Skip the header, the name is quoted because it can contain commas
+	std::string line;
+	std::getline(file, line);
+	for (size_t number = 2; std::getline(file, line); number++)
+	{
+		if (line.empty())
+		{
+			continue;
+		}
+		size_t end = line.find('"', 1);
+		size_t size;
+		double median;
+		char comma;
+		if (line[0] != '"' || end == std::string::npos || end + 2 > line.size() || line[end + 1] != ',')
+		{
+			std::cerr << path << ':' << number << ": expected a quoted benchmark name followed by a comma" << std::endl;
+			return false;
+		}
+		std::istringstream values(line.substr(end + 2));
+		if (!(values >> size >> comma >> median) || comma != ',')
+		{
+			std::cerr << path << ':' << number << ": expected the number of entities and the median time" << std::endl;
+			return false;
+		}
+		baseline[{ line.substr(1, end - 1), size }] = median;
+	}
+	return true;
+}
+
+/**
+ * @brief Main function of the benchmarks
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments. --csv <file> and --json <file> write the results, --baseline <file> compares them with the
+ * CSV of an earlier run and fails if a benchmark got slower by more than --tolerance <fraction> (default 0.1).
+ * --samples <n> sets the number of runs per benchmark (default 5), --max-entities <n> skips larger sizes and
+ * --filter <text> only runs benchmarks whose name contains the text. Baseline entries without a result of this run
+ * are reported, and fail the run with --fail-on-missing
+ * @return int 0 if there was no regression, 1 otherwise or if an option is invalid
+ */
+int main(int argc, char* argv[])
+{
+	std::string csvPath, jsonPath, baselinePath, filter;
+	double tolerance = 0.1;
+	std::uint64_t samples = 5, maxEntities = 1000000;
+	bool failOnMissing = false;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+		if (option == "--fail-on-missing")
+		{
+			failOnMissing = true;
+			continue;
+		}
+
+		// Every other option takes a value
+		if (i + 1 >= argc)
+		{
+			std::cerr << "Option " << option << " needs a value" << std::endl;
+			return 1;
+		}
+		const char* value = argv[++i];
+		bool valid = true;
+		if (option == "--csv")
+		{
+			csvPath = value;
+		}
+		else if (option == "--json")
+		{
+			jsonPath = value;
+		}
+		else if (option == "--baseline")
+		{
+			baselinePath = value;
+		}
+		else if (option == "--tolerance")
+		{
+			char* end = nullptr;
+			tolerance = std::strtod(value, &end);
+			valid = end != value && *end == '\0' && tolerance >= 0;
+		}
+		else if (option == "--samples")
+		{
+			valid = ParseNumber(value, std::numeric_limits<int>::max(), samples) && samples > 0;
+		}
+		else if (option == "--max-entities")
+		{
+			valid = ParseNumber(value, std::numeric_limits<size_t>::max(), maxEntities);
+		}
+		else if (option == "--filter")
+		{
+			filter = value;
+		}
+		else
+		{
+			std::cerr << "Unknown option " << option << std::endl;
+			return 1;
+		}
+		if (!valid)
+		{
+			std::cerr << "Invalid value " << value << " of option " << option << std::endl;
+			return 1;
+		}
+	}
+
+	std::map<std::pair<std::string, size_t>, double> baseline;
+	if (!baselinePath.empty() && !ReadBaseline(baselinePath, baseline))
+	{
+		std::cerr << "Could not read the baseline " << baselinePath << std::endl;
+		return 1;
+	}
+
+	// Run every benchmark with every size, from small to large so the quick results show up first
+	std::vector<BenchmarkResult> results;
+	int regressions = 0;
+	std::cout << std::left << std::setw(48) << "benchmark" << std::right << std::setw(10) << "entities" << std::setw(14) << "median ns/e" << std::setw(14) << "min ns/e" << std::setw(12) << "baseline" << '\n';
+	for (size_t size : { 1000, 10000, 100000, 1000000 })
+	{
+		if (size > maxEntities)
+		{
+			continue;
+		}
+		for (const Benchmark* benchmark : Benchmark::All())
+		{
+			if (benchmark->name.find(filter) == std::string::npos)
+			{
+				continue;
+			}
+			BenchmarkResult result = RunBenchmark(*benchmark, size, int(samples));
+			results.push_back(result);
+
+			std::cout << std::left << std::setw(48) << result.name << std::right << std::setw(10) << result.size << std::fixed << std::setprecision(3) << std::setw(14) << result.median << std::setw(14) << result.min;
+			auto previous = baseline.find({ result.name, result.size });
+			if (previous != baseline.end())
+			{
+				double change = result.median / previous->second - 1.0;
+				std::cout << std::setw(11) << std::showpos << std::setprecision(1) << change * 100.0 << '%' << std::noshowpos;
+				if (change > tolerance)
+				{
+					std::cout << "  REGRESSION";
+					regressions++;
+				}
+			}
+			std::cout << std::endl;
+		}
+	}
+
+	if (!csvPath.empty())
+	{
+		std::ofstream csv(csvPath);
+		csv << "name,entities,median_ns_per_entity,min_ns_per_entity\n";
+		for (const BenchmarkResult& result : results)
+		{
+			csv << '"' << result.name << "\"," << result.size << ',' << result.median << ',' << result.min << '\n';
+		}
+	}
+
+	if (!jsonPath.empty())
+	{
+		std::ofstream json(jsonPath);
+		json << "[\n";
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const BenchmarkResult& result = results[i];
+			json << "\t{ \"name\": \"" << result.name << "\", \"entities\": " << result.size << ", \"median_ns_per_entity\": " << result.median << ", \"min_ns_per_entity\": " << result.min << " }" << (i + 1 < results.size() ? "," : "") << '\n';
+		}
+		json << "]\n";
+	}
+
+	// Benchmarks that were renamed, removed or not run can not be compared, so they are reported
+	std::map<std::pair<std::string, size_t>, double> missing = baseline;
+	for (const BenchmarkResult& result : results)
+	{
+		missing.erase({ result.name, result.size });
+	}
+	for (const auto& entry : missing)
+	{
+		std::cout << "MISSING  " << entry.first.first << " with " << entry.first.second << " entities has no result to compare with the baseline" << std::endl;
+	}
+
+	bool failed = false;
+	if (regressions > 0)
+	{
+		std::cout << regressions << " benchmarks are more than " << tolerance * 100.0 << "% slower than the baseline" << std::endl;
+		failed = true;
+	}
+	if (!missing.empty())
+	{
+		std::cout << missing.size() << " benchmarks of the baseline are missing" << (failOnMissing ? "" : ", add --fail-on-missing to fail on them") << std::endl;
+		failed = failed || failOnMissing;
+	}
+	return failed ? 1 : 0;
+}
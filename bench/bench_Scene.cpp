@@ -0,0 +1,158 @@
+#include "Benchmark.hpp"
+
+#include "components/Health.hpp"
+#include "components/Position.hpp"
+#include "components/Velocity.hpp"
+#include "ecs/Scene.hpp"
+#include "ecs/SceneView.hpp"
+
+/**
+ * @brief Create the entities of a run
+ *
+ * @param scene Scene in which the entities are created
+ * @param run Run of a benchmark
+ * @param ids Filled with the IDs of the created entities
+ */
+static void CreateEntities(Scene& scene, const BenchmarkRun& run, std::vector<EntityID>& ids)
+{
+	ids.reserve(run.size);
+	for (size_t i = 0; i < run.size; i++)
+	{
+		ids.push_back(scene.NewEntity());
+	}
+}
+
+/**
+ * @brief Configuration of the scene of a run
+ *
+ * @param run Run of a benchmark
+ * @return SceneConfig Configuration with storage for every entity of the run
+ */
+static SceneConfig ConfigFor(const BenchmarkRun& run)
+{
+	SceneConfig config;
+	config.capacity = run.size;
+	return config;
+}
+
+static Benchmark newEntity("Scene::NewEntity", [](BenchmarkRun& run) {
+	Scene scene(ConfigFor(run));
+	run.Measure([&] {
+		for (size_t i = 0; i < run.size; i++)
+		{
+			KeepResult(scene.NewEntity());
+		}
+	});
+});
+
+static Benchmark assignHealth("Scene::Assign<Health>", [](BenchmarkRun& run) {
+	Scene scene(ConfigFor(run));
+	std::vector<EntityID> ids;
+	CreateEntities(scene, run, ids);
+	run.Measure([&] {
+		for (EntityID id : ids)
+		{
+			scene.Assign<Health>(id);
+		}
+	});
+});
+
+static Benchmark assignPosition("Scene::Assign<Position> (SoA)", [](BenchmarkRun& run) {
+	Scene scene(ConfigFor(run));
+	std::vector<EntityID> ids;
+	CreateEntities(scene, run, ids);
+	run.Measure([&] {
+		for (EntityID id : ids)
+		{
+			scene.Assign<Position>(id);
+		}
+	});
+});
+
+static Benchmark getHealth("Scene::Get<Health>", [](BenchmarkRun& run) {
+	Scene scene(ConfigFor(run));
+	std::vector<EntityID> ids;
+	CreateEntities(scene, run, ids);
+	for (EntityID id : ids)
+	{
+		scene.Assign<Health>(id)->health = 3;
+	}
+	run.Measure([&] {
+		int sum = 0;
+		for (EntityID id : ids)
+		{
+			sum += scene.Get<Health>(id)->health;
+		}
+		KeepResult(sum);
+	});
+});
+
+static Benchmark removeHealth("Scene::Remove<Health>", [](BenchmarkRun& run) {
+	Scene scene(ConfigFor(run));
+	std::vector<EntityID> ids;
+	CreateEntities(scene, run, ids);
+	for (EntityID id : ids)
+	{
+		scene.Assign<Health>(id);
+	}
+	run.Measure([&] {
+		for (EntityID id : ids)
+		{
+			scene.Remove<Health>(id);
+		}
+	});
+});
+
+static Benchmark destroyEntity("Scene::DestroyEntity", [](BenchmarkRun& run) {
+	Scene scene(ConfigFor(run));
+	std::vector<EntityID> ids;
+	CreateEntities(scene, run, ids);
+	for (EntityID id : ids)
+	{
+		scene.Assign<Position>(id);
+		scene.Assign<Velocity>(id);
+		scene.Assign<Health>(id);
+	}
+	run.Measure([&] {
+		for (EntityID id : ids)
+		{
+			scene.DestroyEntity(id);
+		}
+	});
+});
+
+/**
+ * @brief Iterate the entities with position and velocity, of which only a part has a velocity
+ *
+ * @param percent Percentage of the entities that match the view
+ * @return std::function<void(BenchmarkRun&)> Function of the benchmark
+ */
+static std::function<void(BenchmarkRun&)> IterateView(size_t percent)
+{
+	return [percent](BenchmarkRun& run) {
+		Scene scene(ConfigFor(run));
+		std::vector<EntityID> ids;
+		CreateEntities(scene, run, ids);
+		for (size_t i = 0; i < ids.size(); i++)
+		{
+			scene.Assign<Position>(ids[i]);
+			// Spread the matching entities evenly over the scene
+			if (i * percent % 100 < percent)
+			{
+				scene.Assign<Velocity>(ids[i]);
+			}
+		}
+		run.Measure([&] {
+			int sum = 0;
+			SceneView<Position, Velocity>(scene).ForEach([&](EntityID id, ComponentRef<Position> position, ComponentRef<Velocity> velocity) {
+				sum += position.x + velocity.x;
+			});
+			KeepResult(sum);
+		});
+	};
+}
+
+static Benchmark viewAll("SceneView<Position, Velocity> 100% match", IterateView(100));
+static Benchmark viewHalf("SceneView<Position, Velocity> 50% match", IterateView(50));
+static Benchmark viewTenth("SceneView<Position, Velocity> 10% match", IterateView(10));
+static Benchmark viewHundredth("SceneView<Position, Velocity> 1% match", IterateView(1));
@@ -0,0 +1,78 @@
+#include "Benchmark.hpp"
+
+#include "Simulation.hpp"
+#include <memory>
+
+/**
+ * @brief Create a simulation with the entities of a run, that already ran one tick
+ *
+ * The world has about one cell per entity, so the collisions scale with the number of entities. After the first
+ * tick the entities move, the spatial index is filled and the cached queries exist.
+ *
+ * @param run Run of a benchmark
+ * @param collisionMode Way in which the collision system finds colliding entities
+ * @return std::unique_ptr<Simulation> Simulation in the state of the second tick
+ */
+static std::unique_ptr<Simulation> CreateSimulation(const BenchmarkRun& run, CollisionMode collisionMode = CollisionMode::Incremental)
+{
+	SceneConfig config;
+	config.capacity = run.size;
+	int side = std::max(int(std::sqrt(double(run.size))), 16);
+
+	srand(1);
+	std::unique_ptr<Simulation> simulation(new Simulation(World(side, side), config, collisionMode, 1));
+	for (size_t i = 0; i < run.size; i++)
+	{
+		simulation->Spawn();
+	}
+	simulation->Tick(16.0f);
+	return simulation;
+}
+
+static Benchmark movement("MovementSystem::update", [](BenchmarkRun& run) {
+	auto simulation = CreateSimulation(run);
+	run.Measure([&] { simulation->movementSystem.update(simulation->scene, 16.0f, simulation->world); });
+});
+
+static Benchmark ki("KiSystem::update", [](BenchmarkRun& run) {
+	auto simulation = CreateSimulation(run);
+	run.Measure([&] { simulation->kiSystem.update(simulation->scene, 16.0f); });
+});
+
+static Benchmark collisionIncremental("CollisionSystem::update (incremental)", [](BenchmarkRun& run) {
+	auto simulation = CreateSimulation(run);
+	simulation->movementSystem.update(simulation->scene, 16.0f, simulation->world);
+	run.Measure([&] { simulation->collisionSystem.update(simulation->scene, 16.0f, simulation->world); });
+});
+
+static Benchmark collisionGrid("CollisionSystem::update (grid)", [](BenchmarkRun& run) {
+	auto simulation = CreateSimulation(run, CollisionMode::Grid);
+	simulation->movementSystem.update(simulation->scene, 16.0f, simulation->world);
+	run.Measure([&] { simulation->collisionSystem.update(simulation->scene, 16.0f, simulation->world); });
+});
+
+static Benchmark collisionSort("CollisionSystem::update (sort)", [](BenchmarkRun& run) {
+	auto simulation = CreateSimulation(run, CollisionMode::SortAndSweep);
+	simulation->movementSystem.update(simulation->scene, 16.0f, simulation->world);
+	run.Measure([&] { simulation->collisionSystem.update(simulation->scene, 16.0f, simulation->world); });
+});
+
+static Benchmark damage("DamageSystem::update", [](BenchmarkRun& run) {
+	auto simulation = CreateSimulation(run);
+	simulation->movementSystem.update(simulation->scene, 16.0f, simulation->world);
+	simulation->collisionSystem.update(simulation->scene, 16.0f, simulation->world);
+	run.Measure([&] { simulation->damageSystem.update(simulation->scene, 16.0f); });
+});
+
+static Benchmark health("HealthSystem::update", [](BenchmarkRun& run) {
+	auto simulation = CreateSimulation(run);
+	simulation->movementSystem.update(simulation->scene, 16.0f, simulation->world);
+	simulation->collisionSystem.update(simulation->scene, 16.0f, simulation->world);
+	simulation->damageSystem.update(simulation->scene, 16.0f);
+	run.Measure([&] { simulation->healthSystem.update(simulation->scene, 16.0f); });
+});
+
+static Benchmark tick("Simulation::Tick", [](BenchmarkRun& run) {
+	auto simulation = CreateSimulation(run);
+	run.Measure([&] { simulation->Tick(16.0f); });
+});
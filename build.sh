@@ -209,7 +209,7 @@ if [[ $PLATFORM == 'windows' ]]; then
 	fi
 fi
 
-if [[ $BUILD != "Release" && $BUILD != 'Debug' && $BUILD != 'Tests' ]]; then
+if [[ $BUILD != "Release" && $BUILD != 'Debug' && $BUILD != 'Tests' && $BUILD != 'Headless' && $BUILD != 'Bench' ]]; then
 	BUILD=Release
 fi
 
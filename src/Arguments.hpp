@@ -0,0 +1,74 @@
+#pragma once
+
+#include "systems/CollisionSystem.hpp"
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+/**
+ * @brief Parse a command line argument as an unsigned decimal number
+ *
+ * @param text Argument
+ * @param max Largest value that is accepted
+ * @param value Parsed number, only written if the argument is valid
+ * @return true True if the whole argument is a number of at most max
+ * @return false False if the argument is empty, contains anything but digits or is too large
+ */
+inline bool ParseNumber(const char* text, std::uint64_t max, std::uint64_t& value)
+{
+	if (text[0] == '\0')
+	{
+		return false;
+	}
+	for (const char* c = text; *c != '\0'; c++)
+	{
+		if (!std::isdigit(static_cast<unsigned char>(*c)))
+		{
+			return false;
+		}
+	}
+
+	errno = 0;
+	unsigned long long parsed = std::strtoull(text, nullptr, 10);
+	if (errno == ERANGE || parsed > max)
+	{
+		return false;
+	}
+	value = parsed;
+	return true;
+}
+
+/**
+ * @brief Parse the name of a collision mode
+ *
+ * @param text Argument, one of bruteforce, grid, incremental or sort
+ * @param mode Parsed mode, only written if the name is known
+ * @return true True if the name is a collision mode
+ * @return false False if the name is unknown
+ */
+inline bool ParseCollisionMode(const std::string& text, CollisionMode& mode)
+{
+	if (text == "bruteforce")
+	{
+		mode = CollisionMode::BruteForce;
+	}
+	else if (text == "grid")
+	{
+		mode = CollisionMode::Grid;
+	}
+	else if (text == "incremental")
+	{
+		mode = CollisionMode::Incremental;
+	}
+	else if (text == "sort")
+	{
+		mode = CollisionMode::SortAndSweep;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * @brief Clock that turns the real time between frames into a whole number of simulation ticks of fixed length
+ *
+ * The elapsed time is collected in an accumulator, and every full tick length is handed out as one tick. Left over
+ * time is kept for the next frame. The time is counted in whole microseconds, so no rounding error builds up.
+ * If the simulation falls behind by more than the catch-up budget, the time that would need more ticks is dropped,
+ * so slow frames don't lead to even more ticks in the next frame.
+ *
+ */
+struct FixedTimestep
+{
+	/**
+	 * @brief Construct a new Fixed Timestep object
+	 *
+	 * @param tickRate Number of ticks per second
+	 * @param maxTicks Maximum number of ticks that are run in one frame to catch up
+	 */
+	FixedTimestep(unsigned int tickRate, unsigned int maxTicks = 5) :
+		tickLength(1000000 / std::max(tickRate, 1u)),
+		maxTicks(std::max(maxTicks, 1u))
+	{
+	}
+
+	/**
+	 * @brief Add the real time that passed and get the number of ticks that have to be run now
+	 *
+	 * @param elapsed Time since the last call in microseconds
+	 * @return unsigned int Number of ticks, at most maxTicks
+	 */
+	unsigned int Advance(std::int64_t elapsed)
+	{
+		accumulator += std::max<std::int64_t>(elapsed, 0);
+		std::int64_t due = accumulator / tickLength;
+		if (due > maxTicks)
+		{
+			// Drop the time that exceeds the budget, but keep the fraction of the next tick
+			dropped += due - maxTicks;
+			accumulator -= (due - maxTicks) * tickLength;
+			due = maxTicks;
+		}
+		accumulator -= due * tickLength;
+		ticks += due;
+		return unsigned(due);
+	}
+
+	/**
+	 * @brief Get the length of one tick, as passed to the systems
+	 *
+	 * @return float Length of one tick in milliseconds
+	 */
+	inline float TickTime() const
+	{
+		return float(tickLength) / 1000.0f;
+	}
+
+	/**
+	 * @brief Get how far the time has advanced into the next tick, e.g. to interpolate what is rendered
+	 *
+	 * @return float Fraction of the next tick between 0 and 1
+	 */
+	inline float Alpha() const
+	{
+		return float(accumulator) / float(tickLength);
+	}
+
+	/**
+	 * @brief Length of one tick in microseconds
+	 *
+	 */
+	std::int64_t tickLength;
+
+	/**
+	 * @brief Maximum number of ticks that are run in one frame
+	 *
+	 */
+	unsigned int maxTicks;
+
+	/**
+	 * @brief Time that passed but was not handed out as a tick yet, in microseconds
+	 *
+	 */
+	std::int64_t accumulator { 0 };
+
+	/**
+	 * @brief Number of ticks that were handed out
+	 *
+	 */
+	std::uint64_t ticks { 0 };
+
+	/**
+	 * @brief Number of ticks that were dropped because they exceeded the catch-up budget
+	 *
+	 */
+	std::uint64_t dropped { 0 };
+};
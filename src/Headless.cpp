@@ -0,0 +1,113 @@
+#include "Arguments.hpp"
+#include "FixedTimestep.hpp"
+#include "Simulation.hpp"
+#include "World.hpp"
+#include <chrono>
+#include <limits>
+#include <stdlib.h>
+
+/**
+ * @brief Counter of components
+ *
+ */
+int s_componentCounter = 0;
+
+/**
+ * @brief Arguments of the headless runner
+ *
+ */
+const char* const USAGE = "usage: headless [entities] [ticks] [bruteforce|grid|incremental|sort] [seed] [snapshot]";
+
+/**
+ * @brief Main function of the headless runner. Runs the same simulation as the windowed programm, without rendering,
+ * as fast as possible and prints its throughput
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments. The first one optionally sets the number of entities, the second one the number of ticks,
+ * the third one the collision mode (bruteforce, grid or sort instead of the incremental default), the fourth one
+ * the seed of the simulation and the fifth one a snapshot file. If the file exists, the simulation is restored from it
+ * instead of spawning entities, and the scene is saved to it after the last tick
+ * @return int Exit code, 1 if an argument is invalid or the snapshot could not be loaded or saved
+ */
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h"))
+	{
+		std::cout << USAGE << std::endl;
+		return 0;
+	}
+
+	// Invalid arguments are rejected, so a batch run never measures something else than it asked for
+	SceneConfig config;
+	std::uint64_t entities = config.capacity, tickCount = 1000, seed = 0;
+	CollisionMode collisionMode = CollisionMode::Incremental;
+	if ((argc > 1 && !ParseNumber(argv[1], std::numeric_limits<EntityIndex>::max() - 1, entities))
+		|| (argc > 2 && !ParseNumber(argv[2], std::numeric_limits<std::uint64_t>::max(), tickCount))
+		|| (argc > 3 && !ParseCollisionMode(argv[3], collisionMode))
+		|| (argc > 4 && !ParseNumber(argv[4], std::numeric_limits<std::uint32_t>::max(), seed))
+		|| argc > 6)
+	{
+		std::cerr << USAGE << std::endl;
+		return 1;
+	}
+	config.capacity = size_t(entities);
+
+	std::string snapshotPath;
+	if (argc > 5)
+	{
+		snapshotPath = argv[5];
+	}
+
+	// Same world and tick length as the default window, so the results are comparable
+	srand(unsigned(seed));
+	Simulation simulation(World(800, 800), config, collisionMode, std::uint32_t(seed));
+	auto loadStart = std::chrono::steady_clock::now();
+	if (!snapshotPath.empty() && util::fs::exists(snapshotPath))
+	{
+		// Never spawn over a file that exists, saving would replace it
+		if (!simulation.Load(snapshotPath))
+		{
+			std::cerr << "Could not load the snapshot " << snapshotPath << std::endl;
+			return 1;
+		}
+		double loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+		std::cout << "Restored " << simulation.scene.entities.size() - simulation.scene.freeEntities.size() << " entities from " << snapshotPath << " in " << loadTime << " ms" << std::endl;
+	}
+	else
+	{
+		for (size_t i = 0; i < config.capacity; i++)
+		{
+			simulation.Spawn();
+		}
+	}
+	FixedTimestep timestep(60);
+	size_t entityCount = simulation.scene.entities.size() - simulation.scene.freeEntities.size();
+
+	// Entities die in collisions, so the work of a tick is counted with the entities that are alive at its start
+	std::uint64_t entityTicks = 0;
+	auto start = std::chrono::steady_clock::now();
+	while (simulation.ticks < tickCount)
+	{
+		entityTicks += simulation.scene.entities.size() - simulation.scene.freeEntities.size();
+		simulation.Tick(timestep.TickTime());
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << entityCount << " entities, " << simulation.ticks << " ticks in " << seconds << " s" << std::endl;
+	std::cout << double(simulation.ticks) / seconds << " ticks/s, " << double(entityTicks) / seconds << " entity ticks/s" << std::endl;
+	std::cout << simulation.scene.entities.size() - simulation.scene.freeEntities.size() << " entities alive" << std::endl;
+
+	if (!snapshotPath.empty())
+	{
+		auto saveStart = std::chrono::steady_clock::now();
+		if (!simulation.Save(snapshotPath))
+		{
+			std::cerr << "Could not save the snapshot to " << snapshotPath << std::endl;
+			return 1;
+		}
+		double saveTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - saveStart).count();
+		std::cout << "Saved the scene to " << snapshotPath << " in " << saveTime << " ms" << std::endl;
+	}
+
+	return 0;
+}
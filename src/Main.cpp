@@ -1,18 +1,17 @@
+#include "Arguments.hpp"
+#include "FixedTimestep.hpp"
 #include "Platform/Platform.hpp"
+#include "Profiler.hpp"
+#include "RenderPipeline.hpp"
+#include "Simulation.hpp"
 #include "World.hpp"
-#include "components/Health.hpp"
-#include "components/Position.hpp"
 #include "components/Sprite.hpp"
-#include "components/Velocity.hpp"
 #include "ecs/Scene.hpp"
 #include "ecs/Util.hpp"
-#include "systems/CollisionSystem.hpp"
-#include "systems/DamageSystem.hpp"
-#include "systems/HealthSystem.hpp"
-#include "systems/KiSystem.hpp"
-#include "systems/MovementSystem.hpp"
 #include "systems/RenderSystem.hpp"
 #include <bitset>
+#include <fstream>
+#include <limits>
 #include <stdlib.h>
 #include <vector>
 
@@ -24,13 +23,46 @@ int s_componentCounter = 0;
 
 int frames = 0;
 
+/**
+ * @brief Arguments of the programm
+ *
+ */
+const char* const USAGE = "usage: SGSE_Sim_ECS [entities] [bruteforce|grid|incremental|sort] [ticks per second] [profile.csv]";
+
 /**
  * @brief Main function of the programm
  *
- * @return int Exit code
+ * @param argc Number of arguments
+ * @param argv Arguments. The first one optionally sets the number of entities, the second one the collision mode
+ * (bruteforce, grid or sort instead of the incremental default), the third one the number of simulation ticks per
+ * second (0 to run one tick per frame with the measured frame time, as without a fixed timestep), the fourth one a
+ * CSV file the profiler statistics are written to once a second. F3 shows the profiler overlay
+ * @return int Exit code, 1 if an argument is invalid
  */
-int main()
+int main(int argc, char* argv[])
 {
+	if (argc > 1 && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h"))
+	{
+		std::cout << USAGE << std::endl;
+		return 0;
+	}
+
+	// Storage is reserved for the requested number of entities, the collision mode can be selected for comparison,
+	// and the simulation runs at a fixed rate by default, so runs don't depend on the frame rate
+	SceneConfig config;
+	std::uint64_t entities = config.capacity, tickRate = 60;
+	CollisionMode collisionMode = CollisionMode::Incremental;
+	if ((argc > 1 && !ParseNumber(argv[1], std::numeric_limits<EntityIndex>::max() - 1, entities))
+		|| (argc > 2 && !ParseCollisionMode(argv[2], collisionMode))
+		|| (argc > 3 && !ParseNumber(argv[3], std::numeric_limits<unsigned int>::max(), tickRate))
+		|| argc > 5)
+	{
+		std::cerr << USAGE << std::endl;
+		return 1;
+	}
+	config.capacity = size_t(entities);
+	FixedTimestep timestep(static_cast<unsigned int>(tickRate));
+
 	// Create window
 	util::Platform platform;
 	sf::RenderWindow window;
@@ -42,62 +74,105 @@ int main()
 	sf::Event event;
 	sf::Clock deltaClock;
 
-	// Create world
-	World world(1 * window.getSize().x, 1 * window.getSize().y);
-
-	Scene scene;
+	// Create the world, the scene and the systems that simulate it
+	Simulation simulation(World(1 * window.getSize().x, 1 * window.getSize().y), config, collisionMode);
+	Scene& scene = simulation.scene;
 
 	// Create entities
-	for (int i = 0; i < NUM_OF_ENTITIES; i++)
+	for (size_t i = 0; i < config.capacity; i++)
 	{
-		Position spawnPos = world.getRandomPos();
-		auto id = scene.NewEntity();
-		auto pos = scene.Assign<Position>(id);
-		pos->x = spawnPos.x;
-		pos->y = spawnPos.y;
+		auto id = simulation.Spawn();
 		auto sprite = scene.Assign<Sprite>(id);
-		sprite->shape.setRadius(1);
-		sprite->shape.setFillColor(sf::Color::White);
-		scene.Assign<Velocity>(id);
-		auto health = scene.Assign<Health>(id);
-		health->health = 3;
+		sprite->radius = 1;
+		sprite->color = sf::Color::White;
 	}
 
-	// Create used systems
+	// Rendering is not part of a tick, it draws a snapshot of the state after the ticks of a frame
 	RenderSystem renderSystem;
-	MovementSystem movementSystem;
-	KiSystem kiSystem;
-	DamageSystem damageSystem;
-	HealthSystem healthSystem;
-	CollisionSystem collisionSystem;
 
-	while (window.isOpen())
+	// Time every system, the ticks of a frame, the capture of the snapshot and the drawing on the render thread
+	Profiler profiler;
+	simulation.scheduler.Profile(&profiler);
+	size_t ticksSection = profiler.Section("Ticks");
+	size_t captureSection = profiler.Section("Capture");
+	size_t renderSection = profiler.Section("Render");
+	bool showOverlay = false;
+	std::ofstream profile;
+	if (argc > 4)
+	{
+		profile.open(argv[4]);
+		Profiler::WriteCsvHeader(profile);
+	}
+
+	// Frame N is drawn on the render thread while frame N+1 is simulated on this one. The overlay labels its
+	// bars if there is a font
+	RenderPipeline pipeline(window, renderSystem);
+	pipeline.overlay.LoadFont("content/profiler.ttf");
+
+	float dt = 0;
+	bool open = true;
+	while (open)
 	{
 		while (window.pollEvent(event))
 		{
 			if (event.type == sf::Event::Closed)
-				window.close();
+				open = false;
+			if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3)
+				showOverlay = !showOverlay;
 		}
 
-		// Clear window and get delta time
-		window.clear();
-		float dt = deltaClock.restart().asMilliseconds();
+		// Get delta time
+		std::int64_t elapsed = deltaClock.restart().asMicroseconds();
+		dt = float(elapsed / 1000);
 		// Update systems
-		movementSystem.update(scene, dt, world);
-		renderSystem.update(scene, dt, window);
-		kiSystem.update(scene, dt);
-		damageSystem.update(scene, dt);
-		healthSystem.update(scene, dt);
-		collisionSystem.update(scene, dt);
-		// Display window and print delta time
-		window.display();
-		std::cout << dt << std::endl;
+		{
+			ScopedTimer timer(&profiler, ticksSection, scene.entities.size() - scene.freeEntities.size());
+			if (tickRate > 0)
+			{
+				for (unsigned int ticks = timestep.Advance(elapsed); ticks > 0; ticks--)
+				{
+					simulation.Tick(timestep.TickTime());
+				}
+			}
+			else
+			{
+				simulation.Tick(dt);
+			}
+		}
+
+		// Hand the state of this frame to the render thread
+		RenderPipeline::Frame& frame = pipeline.Back();
+		{
+			ScopedTimer timer(&profiler, captureSection, scene.Count<Position, Sprite>());
+			renderSystem.capture(scene, frame.snapshot);
+		}
+		profiler.Record(renderSection, pipeline.drawTime.load(std::memory_order_relaxed), frame.snapshot.sprites.size());
+		frame.showProfiler = showOverlay;
+		if (showOverlay)
+		{
+			frame.profiler = profiler;
+		}
+		pipeline.Publish();
+
+		// Print the statistics once a second
+		if (frames % 60 == 0)
+		{
+			profiler.WriteSummary(std::cout);
+			if (profile.is_open())
+			{
+				profiler.WriteCsv(profile, frames);
+			}
+		}
 
 		if (frames++ >= 600)
 		{
-			window.close();
+			open = false;
 		}
 	}
+	pipeline.Stop();
+	window.close();
+
+	std::cout << simulation.ticks << " ticks, " << timestep.dropped << " dropped" << std::endl;
 
 	return 0;
 }
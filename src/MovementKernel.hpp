@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#include <immintrin.h>
+	#define MOVEMENT_SIMD
+#endif
+
+/**
+ * @brief Number of entities that are moved by one call of the movement kernel, one per bit of a bitmap word
+ *
+ */
+const size_t MOVEMENT_WORD_ENTITIES = 64;
+
+/**
+ * @brief Move the entities of one bitmap word, one entity at a time, but without branches
+ *
+ * An axis is only moved if the position after moving it is inside the world. The vertical movement is checked
+ * with the horizontal position that was already updated, like in World::inWorld called once per axis.
+ *
+ * @param x Horizontal positions of 64 consecutive entities
+ * @param y Vertical positions of the entities
+ * @param vx Horizontal velocities of the entities
+ * @param vy Vertical velocities of the entities
+ * @param bits Bit i is set if entity i has to be moved, the other positions are left as they are
+ * @param sizeX Horizontal size of the world
+ * @param sizeY Vertical size of the world
+ * @return std::uint64_t Bit i is set if the position of entity i changed
+ */
+inline std::uint64_t MoveWordScalar(int* x, int* y, const int* vx, const int* vy, std::uint64_t bits, int sizeX, int sizeY)
+{
+	// Positions of entities that are not moved may be uninitialized, so the sums wrap instead of overflowing
+	std::uint64_t moved = 0;
+	for (size_t i = 0; i < MOVEMENT_WORD_ENTITIES; i++)
+	{
+		bool move = (bits >> i) & 1;
+		int oldX = x[i], oldY = y[i];
+		int newX = int(unsigned(x[i]) + unsigned(vx[i]));
+		bool inX = move && newX >= 0 && newX < sizeX && y[i] >= 0 && y[i] < sizeY;
+		x[i] = inX ? newX : x[i];
+		int newY = int(unsigned(y[i]) + unsigned(vy[i]));
+		bool inY = move && x[i] >= 0 && x[i] < sizeX && newY >= 0 && newY < sizeY;
+		y[i] = inY ? newY : y[i];
+		moved |= std::uint64_t(x[i] != oldX || y[i] != oldY) << i;
+	}
+	return moved;
+}
+
+#ifdef MOVEMENT_SIMD
+/**
+ * @brief Get a mask of the lanes that are inside the world, 4 lanes at a time
+ *
+ * @param x Horizontal positions
+ * @param y Vertical positions
+ * @param sizeX Horizontal size of the world in every lane
+ * @param sizeY Vertical size of the world in every lane
+ * @return __m128i All bits of a lane are set if the lane is inside the world
+ */
+__attribute__((target("sse4.1"))) inline __m128i InWorldSse41(__m128i x, __m128i y, __m128i sizeX, __m128i sizeY)
+{
+	__m128i minusOne = _mm_set1_epi32(-1);
+	__m128i inX = _mm_and_si128(_mm_cmpgt_epi32(x, minusOne), _mm_cmpgt_epi32(sizeX, x));
+	__m128i inY = _mm_and_si128(_mm_cmpgt_epi32(y, minusOne), _mm_cmpgt_epi32(sizeY, y));
+	return _mm_and_si128(inX, inY);
+}
+
+/**
+ * @brief Move the entities of one bitmap word, 4 entities at a time. Same result as MoveWordScalar
+ *
+ * @param x Horizontal positions of 64 consecutive entities
+ * @param y Vertical positions of the entities
+ * @param vx Horizontal velocities of the entities
+ * @param vy Vertical velocities of the entities
+ * @param bits Bit i is set if entity i has to be moved, the other positions are left as they are
+ * @param sizeX Horizontal size of the world
+ * @param sizeY Vertical size of the world
+ * @return std::uint64_t Bit i is set if the position of entity i changed
+ */
+__attribute__((target("sse4.1"))) inline std::uint64_t MoveWordSse41(int* x, int* y, const int* vx, const int* vy, std::uint64_t bits, int sizeX, int sizeY)
+{
+	__m128i worldX = _mm_set1_epi32(sizeX);
+	__m128i worldY = _mm_set1_epi32(sizeY);
+	__m128i laneBits = _mm_setr_epi32(1, 2, 4, 8);
+	std::uint64_t moved = 0;
+	for (size_t i = 0; i < MOVEMENT_WORD_ENTITIES; i += 4, bits >>= 4)
+	{
+		if ((bits & 0xF) == 0)
+		{
+			continue;
+		}
+		__m128i lanes = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(int(bits & 0xF)), laneBits), laneBits);
+
+		__m128i oldX = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+		__m128i oldY = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i));
+		__m128i posX = oldX, posY = oldY;
+		__m128i newX = _mm_add_epi32(posX, _mm_loadu_si128(reinterpret_cast<const __m128i*>(vx + i)));
+		posX = _mm_blendv_epi8(posX, newX, _mm_and_si128(lanes, InWorldSse41(newX, posY, worldX, worldY)));
+		__m128i newY = _mm_add_epi32(posY, _mm_loadu_si128(reinterpret_cast<const __m128i*>(vy + i)));
+		posY = _mm_blendv_epi8(posY, newY, _mm_and_si128(lanes, InWorldSse41(posX, newY, worldX, worldY)));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(x + i), posX);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(y + i), posY);
+
+		// Lanes where both axes are unchanged are cleared in the mask
+		__m128i same = _mm_and_si128(_mm_cmpeq_epi32(posX, oldX), _mm_cmpeq_epi32(posY, oldY));
+		moved |= std::uint64_t(~_mm_movemask_ps(_mm_castsi128_ps(same)) & 0xF) << i;
+	}
+	return moved;
+}
+
+/**
+ * @brief Get a mask of the lanes that are inside the world, 8 lanes at a time
+ *
+ * @param x Horizontal positions
+ * @param y Vertical positions
+ * @param sizeX Horizontal size of the world in every lane
+ * @param sizeY Vertical size of the world in every lane
+ * @return __m256i All bits of a lane are set if the lane is inside the world
+ */
+__attribute__((target("avx2"))) inline __m256i InWorldAvx2(__m256i x, __m256i y, __m256i sizeX, __m256i sizeY)
+{
+	__m256i minusOne = _mm256_set1_epi32(-1);
+	__m256i inX = _mm256_and_si256(_mm256_cmpgt_epi32(x, minusOne), _mm256_cmpgt_epi32(sizeX, x));
+	__m256i inY = _mm256_and_si256(_mm256_cmpgt_epi32(y, minusOne), _mm256_cmpgt_epi32(sizeY, y));
+	return _mm256_and_si256(inX, inY);
+}
+
+/**
+ * @brief Move the entities of one bitmap word, 8 entities at a time. Same result as MoveWordScalar
+ *
+ * @param x Horizontal positions of 64 consecutive entities
+ * @param y Vertical positions of the entities
+ * @param vx Horizontal velocities of the entities
+ * @param vy Vertical velocities of the entities
+ * @param bits Bit i is set if entity i has to be moved, the other positions are left as they are
+ * @param sizeX Horizontal size of the world
+ * @param sizeY Vertical size of the world
+ * @return std::uint64_t Bit i is set if the position of entity i changed
+ */
+__attribute__((target("avx2"))) inline std::uint64_t MoveWordAvx2(int* x, int* y, const int* vx, const int* vy, std::uint64_t bits, int sizeX, int sizeY)
+{
+	__m256i worldX = _mm256_set1_epi32(sizeX);
+	__m256i worldY = _mm256_set1_epi32(sizeY);
+	__m256i laneBits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+	std::uint64_t moved = 0;
+	for (size_t i = 0; i < MOVEMENT_WORD_ENTITIES; i += 8, bits >>= 8)
+	{
+		if ((bits & 0xFF) == 0)
+		{
+			continue;
+		}
+		__m256i lanes = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(int(bits & 0xFF)), laneBits), laneBits);
+
+		__m256i oldX = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+		__m256i oldY = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i));
+		__m256i posX = oldX, posY = oldY;
+		__m256i newX = _mm256_add_epi32(posX, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vx + i)));
+		posX = _mm256_blendv_epi8(posX, newX, _mm256_and_si256(lanes, InWorldAvx2(newX, posY, worldX, worldY)));
+		__m256i newY = _mm256_add_epi32(posY, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vy + i)));
+		posY = _mm256_blendv_epi8(posY, newY, _mm256_and_si256(lanes, InWorldAvx2(posX, newY, worldX, worldY)));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(x + i), posX);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(y + i), posY);
+
+		// Lanes where both axes are unchanged are cleared in the mask
+		__m256i same = _mm256_and_si256(_mm256_cmpeq_epi32(posX, oldX), _mm256_cmpeq_epi32(posY, oldY));
+		moved |= std::uint64_t(~_mm256_movemask_ps(_mm256_castsi256_ps(same)) & 0xFF) << i;
+	}
+	return moved;
+}
+#endif
+
+/**
+ * @brief Move the entities of one bitmap word with the widest instructions the CPU supports
+ *
+ * @param x Horizontal positions of 64 consecutive entities
+ * @param y Vertical positions of the entities
+ * @param vx Horizontal velocities of the entities
+ * @param vy Vertical velocities of the entities
+ * @param bits Bit i is set if entity i has to be moved, the other positions are left as they are
+ * @param sizeX Horizontal size of the world
+ * @param sizeY Vertical size of the world
+ * @return std::uint64_t Bit i is set if the position of entity i changed
+ */
+inline std::uint64_t MoveWord(int* x, int* y, const int* vx, const int* vy, std::uint64_t bits, int sizeX, int sizeY)
+{
+#ifdef MOVEMENT_SIMD
+	static const bool avx2 = __builtin_cpu_supports("avx2");
+	static const bool sse41 = __builtin_cpu_supports("sse4.1");
+	if (avx2)
+	{
+		return MoveWordAvx2(x, y, vx, vy, bits, sizeX, sizeY);
+	}
+	if (sse41)
+	{
+		return MoveWordSse41(x, y, vx, vy, bits, sizeX, sizeY);
+	}
+#endif
+	return MoveWordScalar(x, y, vx, vy, bits, sizeX, sizeY);
+}
@@ -7,12 +7,14 @@
 	#endif
 #endif // _DEBUG
 
-// SFML
-#include <SFML/Audio.hpp>
-#include <SFML/Graphics.hpp>
-#include <SFML/Network.hpp>
-#include <SFML/System.hpp>
-#include <SFML/Window.hpp>
+// SFML, not used by the headless runner
+#ifndef HEADLESS
+	#include <SFML/Audio.hpp>
+	#include <SFML/Graphics.hpp>
+	#include <SFML/Network.hpp>
+	#include <SFML/System.hpp>
+	#include <SFML/Window.hpp>
+#endif // HEADLESS
 
 // Raspberry Pi
 #ifdef SFML_SYSTEM_LINUX
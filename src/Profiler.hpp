@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Timings of one section of a frame, e.g. one system, over the last frames
+ *
+ */
+struct ProfileSection
+{
+	/**
+	 * @brief Get the shortest time of the recorded frames
+	 *
+	 * @return float Time in milliseconds
+	 */
+	float Min() const
+	{
+		return times.empty() ? 0.0f : *std::min_element(times.begin(), times.end());
+	}
+
+	/**
+	 * @brief Get the average time of the recorded frames
+	 *
+	 * @return float Time in milliseconds
+	 */
+	float Average() const
+	{
+		float sum = 0;
+		for (float time : times)
+		{
+			sum += time;
+		}
+		return times.empty() ? 0.0f : sum / float(times.size());
+	}
+
+	/**
+	 * @brief Get the time that the given fraction of the recorded frames did not exceed
+	 *
+	 * @param fraction Fraction between 0 and 1, e.g. 0.99 for the 99th percentile
+	 * @return float Time in milliseconds
+	 */
+	float Percentile(float fraction) const
+	{
+		if (times.empty())
+		{
+			return 0.0f;
+		}
+		std::vector<float> sorted(times);
+		size_t rank = std::min(size_t(fraction * float(sorted.size())), sorted.size() - 1);
+		std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+		return sorted[rank];
+	}
+
+	/**
+	 * @brief Name of the section
+	 *
+	 */
+	std::string name;
+
+	/**
+	 * @brief Times of the last frames in milliseconds, used as a ring buffer once it is full
+	 *
+	 */
+	std::vector<float> times;
+
+	/**
+	 * @brief Position in the ring buffer that the next time overwrites
+	 *
+	 */
+	size_t next { 0 };
+
+	/**
+	 * @brief Number of entities that the section processed in the last frame
+	 *
+	 */
+	size_t entities { 0 };
+
+	/**
+	 * @brief Number of times that were recorded in total
+	 *
+	 */
+	std::uint64_t samples { 0 };
+};
+
+/**
+ * @brief Rolling statistics of the sections of a frame
+ *
+ * Sections are added before the frames run. Every section is recorded by one thread at a time, so sections that
+ * run at the same time on different threads can record without a lock.
+ *
+ */
+struct Profiler
+{
+	/**
+	 * @brief Construct a new Profiler object
+	 *
+	 * @param window Number of frames the statistics are computed over
+	 */
+	Profiler(size_t window = 240) :
+		window(std::max<size_t>(window, 1))
+	{
+	}
+
+	/**
+	 * @brief Get the index of a section, adding it if there is none with this name
+	 *
+	 * @param name Name of the section
+	 * @return size_t Index of the section
+	 */
+	size_t Section(const std::string& name)
+	{
+		for (size_t i = 0; i < sections.size(); i++)
+		{
+			if (sections[i].name == name)
+			{
+				return i;
+			}
+		}
+		sections.emplace_back();
+		sections.back().name = name;
+		sections.back().times.reserve(window);
+		return sections.size() - 1;
+	}
+
+	/**
+	 * @brief Record the time of a section in the current frame
+	 *
+	 * @param section Index of the section
+	 * @param time Time in milliseconds
+	 * @param entities Number of entities that the section processed
+	 */
+	void Record(size_t section, float time, size_t entities)
+	{
+		ProfileSection& stats = sections[section];
+		if (stats.times.size() < window)
+		{
+			stats.times.push_back(time);
+		}
+		else
+		{
+			stats.times[stats.next] = time;
+		}
+		stats.next = (stats.next + 1) % window;
+		stats.entities = entities;
+		stats.samples++;
+	}
+
+	/**
+	 * @brief Write the header of the rows written by WriteCsv
+	 *
+	 * @param out Stream of the CSV file
+	 */
+	static void WriteCsvHeader(std::ostream& out)
+	{
+		out << "frame,section,min_ms,avg_ms,p99_ms,entities\n";
+	}
+
+	/**
+	 * @brief Write one row with the current statistics of every section
+	 *
+	 * @param out Stream of the CSV file
+	 * @param frame Number of the current frame
+	 */
+	void WriteCsv(std::ostream& out, std::uint64_t frame) const
+	{
+		for (const ProfileSection& section : sections)
+		{
+			out << frame << ',' << section.name << ',' << section.Min() << ',' << section.Average() << ',' << section.Percentile(0.99f) << ',' << section.entities << '\n';
+		}
+		out.flush();
+	}
+
+	/**
+	 * @brief Write a table with the current statistics of every section, e.g. to the console
+	 *
+	 * @param out Stream the table is written to
+	 */
+	void WriteSummary(std::ostream& out) const
+	{
+		out << std::left << std::setw(12) << "section" << std::right << std::setw(10) << "min ms" << std::setw(10) << "avg ms" << std::setw(10) << "p99 ms" << std::setw(10) << "entities" << '\n';
+		for (const ProfileSection& section : sections)
+		{
+			out << std::left << std::setw(12) << section.name << std::right << std::fixed << std::setprecision(3) << std::setw(10) << section.Min() << std::setw(10) << section.Average() << std::setw(10) << section.Percentile(0.99f) << std::setw(10) << section.entities << '\n';
+		}
+		out.unsetf(std::ios::floatfield);
+		out.flush();
+	}
+
+	/**
+	 * @brief Number of frames the statistics are computed over
+	 *
+	 */
+	size_t window;
+
+	/**
+	 * @brief Sections in the order they were added
+	 *
+	 */
+	std::vector<ProfileSection> sections;
+};
+
+/**
+ * @brief Timer that records the time from its construction to its destruction as one frame of a section
+ *
+ */
+struct ScopedTimer
+{
+	/**
+	 * @brief Construct a new Scoped Timer object and start timing
+	 *
+	 * @param profiler Profiler that the time is recorded in, nothing is timed if it is null
+	 * @param section Index of the section
+	 * @param entities Number of entities that the section processes
+	 */
+	ScopedTimer(Profiler* profiler, size_t section, size_t entities = 0) :
+		profiler(profiler),
+		section(section),
+		entities(entities)
+	{
+		if (profiler != nullptr)
+		{
+			start = std::chrono::steady_clock::now();
+		}
+	}
+
+	/**
+	 * @brief The time is recorded once, so the timer can not be copied
+	 *
+	 */
+	ScopedTimer(const ScopedTimer&) = delete;
+	ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	/**
+	 * @brief Destroy the Scoped Timer object and record the time
+	 *
+	 */
+	~ScopedTimer()
+	{
+		if (profiler != nullptr)
+		{
+			profiler->Record(section, std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count(), entities);
+		}
+	}
+
+	/**
+	 * @brief Profiler that the time is recorded in, can be null
+	 *
+	 */
+	Profiler* profiler;
+
+	/**
+	 * @brief Index of the section
+	 *
+	 */
+	size_t section;
+
+	/**
+	 * @brief Number of entities that the section processes, can be changed while the timer runs
+	 *
+	 */
+	size_t entities;
+
+	/**
+	 * @brief Time when the timer was started
+	 *
+	 */
+	std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Profiler.hpp"
+#include <sstream>
+
+/**
+ * @brief Overlay that draws the statistics of a profiler over the scene, one bar per section
+ *
+ * The bar shows the average time, a thin line the 99th percentile. The full width of a bar is the time of one frame
+ * at 60 Hz. Sections are drawn in the order they were added, in a repeating set of colors, and are labeled with
+ * their name and numbers if a font was loaded.
+ *
+ */
+struct ProfilerOverlay
+{
+	/**
+	 * @brief Load the font of the labels
+	 *
+	 * @param path Path of the font file
+	 * @return true True if the labels are drawn
+	 * @return false False if the font could not be loaded, then only the bars are drawn
+	 */
+	bool LoadFont(const std::string& path)
+	{
+		hasFont = font.loadFromFile(path);
+		return hasFont;
+	}
+
+	/**
+	 * @brief Draw the statistics of every section
+	 *
+	 * @param profiler Profiler with the statistics
+	 * @param window Window to draw to
+	 */
+	void Draw(const Profiler& profiler, sf::RenderWindow& window)
+	{
+		static const sf::Color colors[] = { sf::Color(230, 80, 80), sf::Color(80, 200, 80), sf::Color(90, 140, 240), sf::Color(230, 200, 60), sf::Color(200, 90, 220), sf::Color(70, 210, 210) };
+		const float frameTime = 1000.0f / 60.0f;
+
+		sf::RectangleShape background(sf::Vector2f(width + 2 * margin, profiler.sections.size() * rowHeight + margin));
+		background.setPosition(0, 0);
+		background.setFillColor(sf::Color(0, 0, 0, 160));
+		window.draw(background);
+
+		for (size_t i = 0; i < profiler.sections.size(); i++)
+		{
+			const ProfileSection& section = profiler.sections[i];
+			float top = margin + i * rowHeight;
+			const sf::Color& color = colors[i % (sizeof(colors) / sizeof(colors[0]))];
+
+			sf::RectangleShape average(sf::Vector2f(std::min(section.Average() / frameTime, 1.0f) * width, rowHeight - 4));
+			average.setPosition(margin, top);
+			average.setFillColor(color);
+			window.draw(average);
+
+			sf::RectangleShape percentile(sf::Vector2f(2, rowHeight - 4));
+			percentile.setPosition(margin + std::min(section.Percentile(0.99f) / frameTime, 1.0f) * width, top);
+			percentile.setFillColor(sf::Color::White);
+			window.draw(percentile);
+
+			if (hasFont)
+			{
+				std::ostringstream label;
+				label.precision(2);
+				label << std::fixed << section.name << "  " << section.Average() << " / " << section.Percentile(0.99f) << " ms  " << section.entities;
+				sf::Text text(label.str(), font, unsigned(rowHeight - 6));
+				text.setPosition(margin + 2, top);
+				text.setFillColor(sf::Color::White);
+				window.draw(text);
+			}
+		}
+	}
+
+	/**
+	 * @brief Font of the labels
+	 *
+	 */
+	sf::Font font;
+
+	/**
+	 * @brief Flag if the font was loaded and labels are drawn
+	 *
+	 */
+	bool hasFont { false };
+
+	/**
+	 * @brief Width of a bar for the time of one frame in pixels
+	 *
+	 */
+	float width { 300 };
+
+	/**
+	 * @brief Height of the row of a section in pixels
+	 *
+	 */
+	float rowHeight { 18 };
+
+	/**
+	 * @brief Space around the bars in pixels
+	 *
+	 */
+	float margin { 6 };
+};
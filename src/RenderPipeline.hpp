@@ -0,0 +1,245 @@
+#pragma once
+
+#include "Profiler.hpp"
+#include "ProfilerOverlay.hpp"
+#include "systems/RenderSystem.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Draws the frames of the simulation on a separate thread, while the next frame is simulated
+ *
+ * The simulation fills the back frame and publishes it. The render thread takes the published frame, draws it and
+ * displays the window. There are two frames, so the simulation can fill one while the other one is drawn. Snapshots
+ * only hold the changes since the last one, so no frame is skipped: if the render thread did not take the last frame
+ * yet, the simulation waits before it publishes the next one. If the render thread still draws the frame that would
+ * become the back frame, the simulation waits for it as well.
+ *
+ * The window is only drawn to by the render thread, events have to be polled by the thread that created it.
+ *
+ */
+struct RenderPipeline
+{
+	/**
+	 * @brief Frame that is handed from the simulation to the render thread
+	 *
+	 */
+	struct Frame
+	{
+		/**
+		 * @brief Entities that are drawn
+		 *
+		 */
+		RenderSnapshot snapshot;
+
+		/**
+		 * @brief Copy of the profiler statistics at the time of the frame
+		 *
+		 */
+		Profiler profiler;
+
+		/**
+		 * @brief Flag if the profiler overlay is drawn over the entities
+		 *
+		 */
+		bool showProfiler { false };
+	};
+
+	/**
+	 * @brief Construct a new Render Pipeline object and start the render thread
+	 *
+	 * @param window Window that the frames are drawn to. It is deactivated on the calling thread
+	 * @param renderSystem System that draws the entities, only used by the render thread from now on
+	 */
+	RenderPipeline(sf::RenderWindow& window, RenderSystem& renderSystem) :
+		window(&window),
+		renderSystem(&renderSystem)
+	{
+		window.setActive(false);
+		thread = std::thread([this] { Render(); });
+	}
+
+	/**
+	 * @brief The render thread holds a pointer to the pipeline, so it can not be copied
+	 *
+	 */
+	RenderPipeline(const RenderPipeline&) = delete;
+	RenderPipeline& operator=(const RenderPipeline&) = delete;
+
+	/**
+	 * @brief Destroy the Render Pipeline object and stop the render thread
+	 *
+	 */
+	~RenderPipeline()
+	{
+		Stop();
+	}
+
+	/**
+	 * @brief Get the frame that the simulation fills next
+	 *
+	 * @return Frame& Frame that is not used by the render thread
+	 */
+	inline Frame& Back()
+	{
+		return frames[back];
+	}
+
+	/**
+	 * @brief Hand the back frame to the render thread and switch to the other frame
+	 *
+	 */
+	void Publish()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		// The last published frame has to be drawn before its changes can be followed by the next ones
+		condition.wait(lock, [this] { return published < 0; });
+		published = back;
+		back = 1 - back;
+		condition.notify_all();
+
+		// The new back frame may still be drawn
+		condition.wait(lock, [this] { return drawing != back; });
+	}
+
+	/**
+	 * @brief Stop the render thread once it drew the last published frame and give the window back to this thread
+	 *
+	 */
+	void Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (stopped)
+			{
+				return;
+			}
+			stopped = true;
+		}
+		condition.notify_all();
+		thread.join();
+		window->setActive(true);
+	}
+
+	/**
+	 * @brief Loop of the render thread that draws every frame that is published
+	 *
+	 */
+	void Render()
+	{
+		window->setActive(true);
+		while (true)
+		{
+			int frame;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(lock, [this] { return stopped || published >= 0; });
+				if (published < 0)
+				{
+					break;
+				}
+				frame = drawing = published;
+				published = -1;
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			window->clear();
+			renderSystem->draw(frames[frame].snapshot, *window);
+			if (frames[frame].showProfiler)
+			{
+				overlay.Draw(frames[frame].profiler, *window);
+			}
+			window->display();
+			drawTime.store(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+			drawn.fetch_add(1, std::memory_order_relaxed);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				drawing = -1;
+			}
+			condition.notify_all();
+		}
+		window->setActive(false);
+	}
+
+	/**
+	 * @brief Window that the frames are drawn to
+	 *
+	 */
+	sf::RenderWindow* window;
+
+	/**
+	 * @brief System that draws the entities
+	 *
+	 */
+	RenderSystem* renderSystem;
+
+	/**
+	 * @brief Overlay that draws the profiler statistics of a frame
+	 *
+	 */
+	ProfilerOverlay overlay;
+
+	/**
+	 * @brief The two frames that are filled and drawn in turns
+	 *
+	 */
+	Frame frames[2];
+
+	/**
+	 * @brief Index of the frame that the simulation fills
+	 *
+	 */
+	int back { 0 };
+
+	/**
+	 * @brief Index of the frame that waits to be drawn, -1 if there is none
+	 *
+	 */
+	int published { -1 };
+
+	/**
+	 * @brief Index of the frame that is drawn, -1 if the render thread waits
+	 *
+	 */
+	int drawing { -1 };
+
+	/**
+	 * @brief Flag if the render thread was stopped
+	 *
+	 */
+	bool stopped { false };
+
+	/**
+	 * @brief Time that drawing and displaying the last frame took, in milliseconds
+	 *
+	 */
+	std::atomic<float> drawTime { 0 };
+
+	/**
+	 * @brief Number of frames that were drawn
+	 *
+	 */
+	std::atomic<std::uint64_t> drawn { 0 };
+
+	/**
+	 * @brief Mutex that guards the frame indices
+	 *
+	 */
+	std::mutex mutex;
+
+	/**
+	 * @brief Condition that is notified when a frame is published or drawn, or the pipeline stops
+	 *
+	 */
+	std::condition_variable condition;
+
+	/**
+	 * @brief Thread that draws the frames
+	 *
+	 */
+	std::thread thread;
+};
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "SpatialIndex.hpp"
+#include "World.hpp"
+#include "components/Collision.hpp"
+#include "components/Health.hpp"
+#include "components/Position.hpp"
+#include "components/Velocity.hpp"
+#include "ecs/Scene.hpp"
+#include "ecs/SceneSnapshot.hpp"
+#include "ecs/SystemScheduler.hpp"
+#include "ecs/ThreadPool.hpp"
+#include "systems/CollisionSystem.hpp"
+#include "systems/DamageSystem.hpp"
+#include "systems/HealthSystem.hpp"
+#include "systems/KiSystem.hpp"
+#include "systems/MovementSystem.hpp"
+
+/**
+ * @brief Scene and systems of the simulation, without anything that renders it
+ *
+ * One tick runs every system once with the given delta time. With the same configuration, seed and delta times,
+ * two simulations end in the same state, no matter how many threads they use.
+ *
+ */
+struct Simulation
+{
+	/**
+	 * @brief Construct a new Simulation object
+	 *
+	 * @param world World in which the entities move
+	 * @param config Configuration of the scene
+	 * @param collisionMode Way in which the collision system finds colliding entities
+	 * @param seed Seed of the random movements
+	 */
+	Simulation(const World& world, const SceneConfig& config = SceneConfig(), CollisionMode collisionMode = CollisionMode::Incremental, std::uint32_t seed = 0) :
+		world(world),
+		scene(config),
+		spatialIndex(this->world, 4),
+		movementSystem(nullptr, &threadPool),
+		kiSystem(&threadPool, seed),
+		damageSystem(&threadPool),
+		healthSystem(&threadPool),
+		collisionSystem(spatialIndex),
+		scheduler(threadPool)
+	{
+		// Only publish positions if the collision system reads them from the index
+		collisionSystem.mode = collisionMode;
+		if (collisionMode == CollisionMode::Incremental)
+		{
+			movementSystem.index = &spatialIndex;
+		}
+
+		// Schedule the systems in their tick order, systems that don't conflict run at the same time. The counts of
+		// the entities they iterate are only taken when the scheduler is profiled
+		scheduler.Add("Movement", MovementSystem::Access(), [this] { movementSystem.update(scene, dt, this->world); }, [this] { return scene.Count<Position, Velocity>(); });
+		scheduler.Add("Ki", KiSystem::Access(), [this] { kiSystem.update(scene, dt); }, [this] { return scene.Count<Velocity>(); });
+		scheduler.Add("Damage", DamageSystem::Access(), [this] { damageSystem.update(scene, dt); }, [this] { return scene.Count<Health, Collision>(); });
+		scheduler.Add("Health", HealthSystem::Access(), [this] { healthSystem.update(scene, dt); }, [this] { return scene.Count<Health>(); });
+		scheduler.Add("Collision", CollisionSystem::Access(), [this] { collisionSystem.update(scene, dt, this->world); }, [this] { return scene.Count<Position>(); });
+	}
+
+	/**
+	 * @brief The systems hold pointers into the simulation, so it can not be copied
+	 *
+	 */
+	Simulation(const Simulation&) = delete;
+	Simulation& operator=(const Simulation&) = delete;
+
+	/**
+	 * @brief Create an entity at a random position of the world
+	 *
+	 * @return EntityID ID of the created entity
+	 */
+	EntityID Spawn()
+	{
+		EntityID id = scene.NewEntity();
+		*scene.Assign<Position>(id) = world.getRandomPos();
+		scene.Assign<Velocity>(id);
+		scene.Assign<Health>(id)->health = 3;
+		return id;
+	}
+
+	/**
+	 * @brief Save the entities and components of the scene to a snapshot file
+	 *
+	 * @param path Path of the file, which is overwritten
+	 * @return true True if the snapshot was written
+	 * @return false False if the snapshot could not be written
+	 */
+	bool Save(const std::string& path)
+	{
+		return SceneSnapshot::Save<Position, Velocity, Health, Collision>(scene, path);
+	}
+
+	/**
+	 * @brief Restore the scene from a snapshot file, before any entity was spawned
+	 *
+	 * Only the scene is restored. The systems rebuild their state from it, and the tick count starts over.
+	 *
+	 * @param path Path of the file
+	 * @return true True if the scene was restored
+	 * @return false False if the scene already has entities or the file is not a valid snapshot
+	 */
+	bool Load(const std::string& path)
+	{
+		return SceneSnapshot::Load<Position, Velocity, Health, Collision>(scene, path);
+	}
+
+	/**
+	 * @brief Run every system once
+	 *
+	 * @param tickTime Delta time of this tick in milliseconds
+	 */
+	void Tick(float tickTime)
+	{
+		dt = tickTime;
+		scheduler.Run();
+		ticks++;
+	}
+
+	/**
+	 * @brief World in which the entities move
+	 *
+	 */
+	World world;
+
+	/**
+	 * @brief Scene that holds the entities
+	 *
+	 */
+	Scene scene;
+
+	/**
+	 * @brief Spatial index that the movement system keeps up to date for the collision system
+	 *
+	 */
+	SpatialIndex spatialIndex;
+
+	/**
+	 * @brief Thread pool that the systems split their entities over
+	 *
+	 */
+	ThreadPool threadPool;
+
+	/**
+	 * @brief System that moves the entities
+	 *
+	 */
+	MovementSystem movementSystem;
+
+	/**
+	 * @brief System that picks the movement of the entities
+	 *
+	 */
+	KiSystem kiSystem;
+
+	/**
+	 * @brief System that applies the damage of collisions
+	 *
+	 */
+	DamageSystem damageSystem;
+
+	/**
+	 * @brief System that destroys entities without health
+	 *
+	 */
+	HealthSystem healthSystem;
+
+	/**
+	 * @brief System that finds entities in the same position
+	 *
+	 */
+	CollisionSystem collisionSystem;
+
+	/**
+	 * @brief Scheduler that runs the systems of a tick
+	 *
+	 */
+	SystemScheduler scheduler;
+
+	/**
+	 * @brief Delta time of the current tick in milliseconds
+	 *
+	 */
+	float dt { 0 };
+
+	/**
+	 * @brief Number of ticks that were run
+	 *
+	 */
+	std::uint64_t ticks { 0 };
+};
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "World.hpp"
+#include "components/Position.hpp"
+#include "ecs/Scene.hpp"
+#include "ecs/SceneView.hpp"
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief Uniform grid over the world that sorts entities into cells by their position
+ *
+ * The grid is rebuilt with a counting sort, so building it is O(entities + cells).
+ *
+ */
+struct SpatialGrid
+{
+	/**
+	 * @brief Entity stored in a cell of the grid
+	 *
+	 */
+	struct Entry
+	{
+		/**
+		 * @brief ID of the entity
+		 *
+		 */
+		EntityID id;
+
+		/**
+		 * @brief Position of the entity
+		 *
+		 */
+		Position position;
+	};
+
+	/**
+	 * @brief Set the size of the grid. Does nothing if the size did not change
+	 *
+	 * @param world World that is covered by the grid
+	 * @param size Size of one cell in world units, at least 1
+	 */
+	void Resize(const World& world, int size)
+	{
+		size = std::max(size, 1);
+		int x = (world.sizeX + size - 1) / size;
+		int y = (world.sizeY + size - 1) / size;
+		if (x == cellsX && y == cellsY && size == cellSize)
+		{
+			return;
+		}
+
+		cellSize = size;
+		cellsX = x;
+		cellsY = y;
+		cellStart.assign(size_t(cellsX) * cellsY + 1, 0);
+	}
+
+	/**
+	 * @brief Get the cell that contains a position. Positions outside of the world are put into the border cells
+	 *
+	 * @param position Position in world units
+	 * @return size_t Index of the cell
+	 */
+	inline size_t CellOf(const Position& position) const
+	{
+		int x = std::min(std::max(position.x / cellSize, 0), cellsX - 1);
+		int y = std::min(std::max(position.y / cellSize, 0), cellsY - 1);
+		return size_t(y) * cellsX + x;
+	}
+
+	/**
+	 * @brief Sort all entities with a position into their cells
+	 *
+	 * @param scene Scene that provides entities and components
+	 */
+	void Build(Scene& scene)
+	{
+		unsorted.clear();
+		SceneView<Position>(scene).ForEach([&](EntityID entity, ComponentRef<Position> position) {
+			unsorted.push_back({ entity, position });
+		});
+
+		// Count the entities per cell and turn the counts into the start of each cell
+		std::fill(cellStart.begin(), cellStart.end(), 0);
+		for (const Entry& entry : unsorted)
+		{
+			cellStart[CellOf(entry.position) + 1]++;
+		}
+		for (size_t cell = 1; cell < cellStart.size(); cell++)
+		{
+			cellStart[cell] += cellStart[cell - 1];
+		}
+
+		// Scatter the entities into their cells
+		entries.resize(unsorted.size());
+		fill.assign(cellStart.begin(), cellStart.end() - 1);
+		for (const Entry& entry : unsorted)
+		{
+			entries[fill[CellOf(entry.position)]++] = entry;
+		}
+	}
+
+	/**
+	 * @brief Get the number of cells
+	 *
+	 * @return size_t Number of cells
+	 */
+	inline size_t CellCount() const
+	{
+		return cellStart.size() - 1;
+	}
+
+	/**
+	 * @brief Size of one cell in world units
+	 *
+	 */
+	int cellSize { 0 };
+
+	/**
+	 * @brief Number of cells in horizontal direction
+	 *
+	 */
+	int cellsX { 0 };
+
+	/**
+	 * @brief Number of cells in vertical direction
+	 *
+	 */
+	int cellsY { 0 };
+
+	/**
+	 * @brief Entities sorted by their cell
+	 *
+	 */
+	std::vector<Entry> entries;
+
+	/**
+	 * @brief Index of the first entry of each cell. The entries of a cell end where the next cell starts
+	 *
+	 */
+	std::vector<unsigned int> cellStart;
+
+	/**
+	 * @brief Entities in iteration order, before they are sorted into cells
+	 *
+	 */
+	std::vector<Entry> unsorted;
+
+	/**
+	 * @brief Next free entry of each cell while sorting
+	 *
+	 */
+	std::vector<unsigned int> fill;
+};
\ No newline at end of file
@@ -0,0 +1,297 @@
+#pragma once
+
+#include "World.hpp"
+#include "components/Position.hpp"
+#include "ecs/Scene.hpp"
+#include "ecs/ThreadPool.hpp"
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief Uniform grid over the world that is kept up to date between frames instead of being rebuilt
+ *
+ * Systems that move entities publish their new positions with Update. Only entities that changed their cell
+ * are recorded, and ApplyMoves relinks just those. Every cell is an intrusive list through arrays that are
+ * indexed by the entity index, so moving an entity is O(1) and does not allocate. Cells that hold more than
+ * one entity are kept in a separate list, so finding entities that share a cell only visits those cells.
+ * Every thread of a thread pool records its moves in its own list, so positions can be published in parallel.
+ *
+ */
+struct SpatialIndex
+{
+	/**
+	 * @brief Marker for the end of a cell list and for untracked entities
+	 *
+	 */
+	static constexpr EntityIndex NONE = EntityIndex(-1);
+
+	/**
+	 * @brief Change of the cell of an entity that was published but not applied yet
+	 *
+	 */
+	struct Move
+	{
+		/**
+		 * @brief ID of the entity
+		 *
+		 */
+		EntityID id;
+
+		/**
+		 * @brief Cell the entity moves to
+		 *
+		 */
+		unsigned int cell;
+	};
+
+	/**
+	 * @brief Construct a new Spatial Index object
+	 *
+	 * @param world World that is covered by the index
+	 * @param cellSize Size of one cell in world units, at least 1
+	 */
+	SpatialIndex(const World& world, int cellSize) :
+		cellSize(std::max(cellSize, 1)),
+		cellsX((world.sizeX + this->cellSize - 1) / this->cellSize),
+		cellsY((world.sizeY + this->cellSize - 1) / this->cellSize)
+	{
+		heads.assign(size_t(cellsX) * cellsY, NONE);
+		counts.assign(heads.size(), 0);
+		crowdedSlots.assign(heads.size(), NONE);
+		moves.resize(1);
+	}
+
+	/**
+	 * @brief Make sure that there is a list of moves for every thread that publishes positions
+	 *
+	 * @param threads Number of threads, as counted by ThreadPool::ThreadIndex
+	 */
+	void ReserveThreads(size_t threads)
+	{
+		if (moves.size() < threads)
+		{
+			moves.resize(threads);
+		}
+	}
+
+	/**
+	 * @brief Get the cell that contains a position. Positions outside of the world are put into the border cells
+	 *
+	 * @param position Position in world units
+	 * @return unsigned int Index of the cell
+	 */
+	inline unsigned int CellOf(const Position& position) const
+	{
+		int x = std::min(std::max(position.x / cellSize, 0), cellsX - 1);
+		int y = std::min(std::max(position.y / cellSize, 0), cellsY - 1);
+		return unsigned(y) * cellsX + x;
+	}
+
+	/**
+	 * @brief Publish the current position of an entity. Only entities that are new or changed their cell are recorded
+	 *
+	 * Can be called from several threads of a pool at once, as long as ReserveThreads was called for them.
+	 *
+	 * @param id ID of the entity
+	 * @param position Current position of the entity
+	 */
+	inline void Update(EntityID id, const Position& position)
+	{
+		EntityIndex index = GetEntityIndex(id);
+		unsigned int cell = CellOf(position);
+		if (index < tracked.size() && tracked[index] == id && cells[index] == cell)
+		{
+			return;
+		}
+		moves[ThreadPool::ThreadIndex()].push_back({ id, cell });
+	}
+
+	/**
+	 * @brief Apply the published moves to the cells
+	 *
+	 */
+	void ApplyMoves()
+	{
+		for (std::vector<Move>& threadMoves : moves)
+		{
+			for (const Move& move : threadMoves)
+			{
+				EntityIndex index = GetEntityIndex(move.id);
+				if (tracked.size() <= index)
+				{
+					tracked.resize(index + 1, INVALID_ENTITY);
+					cells.resize(index + 1, NONE);
+					next.resize(index + 1, NONE);
+					previous.resize(index + 1, NONE);
+				}
+
+				// The slot may still hold the old cell of this entity or of a destroyed entity with the same index
+				if (cells[index] != NONE)
+				{
+					Unlink(index);
+				}
+				tracked[index] = move.id;
+				Link(index, move.cell);
+			}
+			threadMoves.clear();
+		}
+	}
+
+	/**
+	 * @brief Remove entities from the crowded cells that were destroyed or lost their position
+	 *
+	 * @param scene Scene that provides entities and components
+	 */
+	void RemoveStale(Scene& scene)
+	{
+		// Walk backwards, since unlinking can remove the current cell from the crowded list
+		int positionId = GetId<Position>();
+		for (size_t slot = crowded.size(); slot-- > 0;)
+		{
+			if (slot >= crowded.size())
+			{
+				continue;
+			}
+			EntityIndex index = heads[crowded[slot]];
+			while (index != NONE)
+			{
+				EntityIndex following = next[index];
+				const Entity& entity = scene.entities[index];
+				if (entity.id != tracked[index] || !entity.mask.test(positionId))
+				{
+					Unlink(index);
+				}
+				index = following;
+			}
+		}
+	}
+
+	/**
+	 * @brief Add an entity to the front of the list of a cell
+	 *
+	 * @param index Index of the entity
+	 * @param cell Index of the cell
+	 */
+	void Link(EntityIndex index, unsigned int cell)
+	{
+		cells[index] = cell;
+		previous[index] = NONE;
+		next[index] = heads[cell];
+		if (heads[cell] != NONE)
+		{
+			previous[heads[cell]] = index;
+		}
+		heads[cell] = index;
+
+		if (++counts[cell] == 2)
+		{
+			crowdedSlots[cell] = EntityIndex(crowded.size());
+			crowded.push_back(cell);
+		}
+	}
+
+	/**
+	 * @brief Remove an entity from the list of its cell
+	 *
+	 * @param index Index of the entity
+	 */
+	void Unlink(EntityIndex index)
+	{
+		unsigned int cell = cells[index];
+		if (previous[index] != NONE)
+		{
+			next[previous[index]] = next[index];
+		}
+		else
+		{
+			heads[cell] = next[index];
+		}
+		if (next[index] != NONE)
+		{
+			previous[next[index]] = previous[index];
+		}
+		cells[index] = NONE;
+
+		if (--counts[cell] == 1)
+		{
+			// Move the last crowded cell into the freed slot
+			EntityIndex slot = crowdedSlots[cell];
+			crowded[slot] = crowded.back();
+			crowdedSlots[crowded[slot]] = slot;
+			crowded.pop_back();
+			crowdedSlots[cell] = NONE;
+		}
+	}
+
+	/**
+	 * @brief Size of one cell in world units
+	 *
+	 */
+	int cellSize;
+
+	/**
+	 * @brief Number of cells in horizontal direction
+	 *
+	 */
+	int cellsX;
+
+	/**
+	 * @brief Number of cells in vertical direction
+	 *
+	 */
+	int cellsY;
+
+	/**
+	 * @brief First entity index of each cell
+	 *
+	 */
+	std::vector<EntityIndex> heads;
+
+	/**
+	 * @brief Number of entities in each cell
+	 *
+	 */
+	std::vector<unsigned int> counts;
+
+	/**
+	 * @brief Cells that hold more than one entity
+	 *
+	 */
+	std::vector<unsigned int> crowded;
+
+	/**
+	 * @brief Slot of each cell in the crowded list
+	 *
+	 */
+	std::vector<EntityIndex> crowdedSlots;
+
+	/**
+	 * @brief Entity stored at each entity index
+	 *
+	 */
+	std::vector<EntityID> tracked;
+
+	/**
+	 * @brief Cell of each entity index
+	 *
+	 */
+	std::vector<unsigned int> cells;
+
+	/**
+	 * @brief Next entity in the same cell
+	 *
+	 */
+	std::vector<EntityIndex> next;
+
+	/**
+	 * @brief Previous entity in the same cell
+	 *
+	 */
+	std::vector<EntityIndex> previous;
+
+	/**
+	 * @brief Moves that were published since the last call of ApplyMoves, one list per thread
+	 *
+	 */
+	std::vector<std::vector<Move>> moves;
+};
\ No newline at end of file
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "Utility/CounterRandom.hpp"
+#include "ecs/Bitmap.hpp"
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#include <immintrin.h>
+	#define STEERING_SIMD
+#endif
+
+/**
+ * @brief Number of entities that are steered by one call of the steering kernel, one per bit of a bitmap word
+ *
+ */
+const size_t STEERING_WORD_ENTITIES = 64;
+
+/**
+ * @brief Turn 16 random bits into one of three directions, without the bias of a modulo
+ *
+ * @param bits Random number, only the lower 16 bits are used
+ * @return int Direction between 0 and 2
+ */
+inline int RandomDirection(std::uint32_t bits)
+{
+	return int(((bits & 0xFFFF) * 3) >> 16);
+}
+
+/**
+ * @brief Get the velocity of one axis for a direction
+ *
+ * @param direction Direction between 0 and 2
+ * @param speed Speed of the movement
+ * @return int Speed for 0, negative speed for 1 and no movement for 2
+ */
+inline int DirectionVelocity(int direction, int speed)
+{
+	return (direction == 0 ? speed : 0) | (direction == 1 ? -speed : 0);
+}
+
+/**
+ * @brief Draw new velocities for the entities of one bitmap word, one entity at a time
+ *
+ * The random number of an entity is util::counterRandom(key, index). Its lower half picks the horizontal
+ * and its upper half the vertical direction.
+ *
+ * @param vx Horizontal velocities of 64 consecutive entities
+ * @param vy Vertical velocities of the entities
+ * @param bits Bit i is set if entity i has to be steered, the other velocities are left as they are
+ * @param first Index of the first entity
+ * @param key Key of the random numbers of this frame
+ * @param speed Speed of the movement
+ */
+inline void SteerWordScalar(int* vx, int* vy, std::uint64_t bits, std::uint32_t first, std::uint32_t key, int speed)
+{
+	for (; bits != 0; bits &= bits - 1)
+	{
+		std::uint32_t i = LowestBit(bits);
+		std::uint32_t random = util::counterRandom(key, first + i);
+		vx[i] = DirectionVelocity(RandomDirection(random), speed);
+		vy[i] = DirectionVelocity(RandomDirection(random >> 16), speed);
+	}
+}
+
+#ifdef STEERING_SIMD
+/**
+ * @brief Draw new velocities for the entities of one bitmap word, 4 entities at a time. Same result as SteerWordScalar
+ *
+ * @param vx Horizontal velocities of 64 consecutive entities
+ * @param vy Vertical velocities of the entities
+ * @param bits Bit i is set if entity i has to be steered, the other velocities are left as they are
+ * @param first Index of the first entity
+ * @param key Key of the random numbers of this frame
+ * @param speed Speed of the movement
+ */
+__attribute__((target("sse4.1"))) inline void SteerWordSse41(int* vx, int* vy, std::uint64_t bits, std::uint32_t first, std::uint32_t key, int speed)
+{
+	__m128i laneBits = _mm_setr_epi32(1, 2, 4, 8);
+	__m128i counters = _mm_add_epi32(_mm_set1_epi32(int(first)), _mm_setr_epi32(0, 1, 2, 3));
+	__m128i keys = _mm_set1_epi32(int(key));
+	__m128i low = _mm_set1_epi32(0xFFFF);
+	__m128i three = _mm_set1_epi32(3);
+	__m128i zero = _mm_setzero_si128();
+	__m128i one = _mm_set1_epi32(1);
+	__m128i positive = _mm_set1_epi32(speed);
+	__m128i negative = _mm_set1_epi32(-speed);
+	for (size_t i = 0; i < STEERING_WORD_ENTITIES; i += 4, bits >>= 4, counters = _mm_add_epi32(counters, _mm_set1_epi32(4)))
+	{
+		if ((bits & 0xF) == 0)
+		{
+			continue;
+		}
+		__m128i lanes = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(int(bits & 0xF)), laneBits), laneBits);
+
+		// util::hash32 of the counters
+		__m128i random = _mm_xor_si128(counters, keys);
+		random = _mm_xor_si128(random, _mm_srli_epi32(random, 16));
+		random = _mm_mullo_epi32(random, _mm_set1_epi32(int(0x7FEB352Du)));
+		random = _mm_xor_si128(random, _mm_srli_epi32(random, 15));
+		random = _mm_mullo_epi32(random, _mm_set1_epi32(int(0x846CA68Bu)));
+		random = _mm_xor_si128(random, _mm_srli_epi32(random, 16));
+
+		__m128i directionX = _mm_srli_epi32(_mm_mullo_epi32(_mm_and_si128(random, low), three), 16);
+		__m128i directionY = _mm_srli_epi32(_mm_mullo_epi32(_mm_srli_epi32(random, 16), three), 16);
+		__m128i velocityX = _mm_or_si128(_mm_and_si128(_mm_cmpeq_epi32(directionX, zero), positive), _mm_and_si128(_mm_cmpeq_epi32(directionX, one), negative));
+		__m128i velocityY = _mm_or_si128(_mm_and_si128(_mm_cmpeq_epi32(directionY, zero), positive), _mm_and_si128(_mm_cmpeq_epi32(directionY, one), negative));
+
+		__m128i oldX = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vx + i));
+		__m128i oldY = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vy + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(vx + i), _mm_blendv_epi8(oldX, velocityX, lanes));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(vy + i), _mm_blendv_epi8(oldY, velocityY, lanes));
+	}
+}
+
+/**
+ * @brief Draw new velocities for the entities of one bitmap word, 8 entities at a time. Same result as SteerWordScalar
+ *
+ * @param vx Horizontal velocities of 64 consecutive entities
+ * @param vy Vertical velocities of the entities
+ * @param bits Bit i is set if entity i has to be steered, the other velocities are left as they are
+ * @param first Index of the first entity
+ * @param key Key of the random numbers of this frame
+ * @param speed Speed of the movement
+ */
+__attribute__((target("avx2"))) inline void SteerWordAvx2(int* vx, int* vy, std::uint64_t bits, std::uint32_t first, std::uint32_t key, int speed)
+{
+	__m256i laneBits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+	__m256i counters = _mm256_add_epi32(_mm256_set1_epi32(int(first)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+	__m256i keys = _mm256_set1_epi32(int(key));
+	__m256i low = _mm256_set1_epi32(0xFFFF);
+	__m256i three = _mm256_set1_epi32(3);
+	__m256i zero = _mm256_setzero_si256();
+	__m256i one = _mm256_set1_epi32(1);
+	__m256i positive = _mm256_set1_epi32(speed);
+	__m256i negative = _mm256_set1_epi32(-speed);
+	for (size_t i = 0; i < STEERING_WORD_ENTITIES; i += 8, bits >>= 8, counters = _mm256_add_epi32(counters, _mm256_set1_epi32(8)))
+	{
+		if ((bits & 0xFF) == 0)
+		{
+			continue;
+		}
+		__m256i lanes = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(int(bits & 0xFF)), laneBits), laneBits);
+
+		// util::hash32 of the counters
+		__m256i random = _mm256_xor_si256(counters, keys);
+		random = _mm256_xor_si256(random, _mm256_srli_epi32(random, 16));
+		random = _mm256_mullo_epi32(random, _mm256_set1_epi32(int(0x7FEB352Du)));
+		random = _mm256_xor_si256(random, _mm256_srli_epi32(random, 15));
+		random = _mm256_mullo_epi32(random, _mm256_set1_epi32(int(0x846CA68Bu)));
+		random = _mm256_xor_si256(random, _mm256_srli_epi32(random, 16));
+
+		__m256i directionX = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_and_si256(random, low), three), 16);
+		__m256i directionY = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(random, 16), three), 16);
+		__m256i velocityX = _mm256_or_si256(_mm256_and_si256(_mm256_cmpeq_epi32(directionX, zero), positive), _mm256_and_si256(_mm256_cmpeq_epi32(directionX, one), negative));
+		__m256i velocityY = _mm256_or_si256(_mm256_and_si256(_mm256_cmpeq_epi32(directionY, zero), positive), _mm256_and_si256(_mm256_cmpeq_epi32(directionY, one), negative));
+
+		__m256i oldX = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vx + i));
+		__m256i oldY = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vy + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(vx + i), _mm256_blendv_epi8(oldX, velocityX, lanes));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(vy + i), _mm256_blendv_epi8(oldY, velocityY, lanes));
+	}
+}
+#endif
+
+/**
+ * @brief Draw new velocities for the entities of one bitmap word with the widest instructions the CPU supports
+ *
+ * @param vx Horizontal velocities of 64 consecutive entities
+ * @param vy Vertical velocities of the entities
+ * @param bits Bit i is set if entity i has to be steered, the other velocities are left as they are
+ * @param first Index of the first entity
+ * @param key Key of the random numbers of this frame
+ * @param speed Speed of the movement
+ */
+inline void SteerWord(int* vx, int* vy, std::uint64_t bits, std::uint32_t first, std::uint32_t key, int speed)
+{
+#ifdef STEERING_SIMD
+	static const bool avx2 = __builtin_cpu_supports("avx2");
+	static const bool sse41 = __builtin_cpu_supports("sse4.1");
+	if (avx2)
+	{
+		SteerWordAvx2(vx, vy, bits, first, key, speed);
+		return;
+	}
+	if (sse41)
+	{
+		SteerWordSse41(vx, vy, bits, first, key, speed);
+		return;
+	}
+#endif
+	SteerWordScalar(vx, vy, bits, first, key, speed);
+}
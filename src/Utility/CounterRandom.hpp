@@ -0,0 +1,55 @@
+#ifndef UTIL_COUNTER_RANDOM_HPP
+#define UTIL_COUNTER_RANDOM_HPP
+
+#include <cstdint>
+
+namespace util
+{
+/**
+ * @brief Mix the bits of a 32 bit value, so that every input bit affects every output bit
+ *
+ * The mixing is a bijection, so different inputs always give different outputs. Only uses shifts, xors and
+ * 32 bit multiplications, so it can be computed for several values at once with SIMD instructions.
+ *
+ * @param x Value that is mixed
+ * @return std::uint32_t Mixed value
+ */
+inline std::uint32_t hash32(std::uint32_t x)
+{
+	x ^= x >> 16;
+	x *= 0x7FEB352Du;
+	x ^= x >> 15;
+	x *= 0x846CA68Bu;
+	x ^= x >> 16;
+	return x;
+}
+
+/**
+ * @brief Get the key of one stream of random numbers, for example the numbers of one frame
+ *
+ * @param seed Seed of the random numbers
+ * @param stream Number of the stream
+ * @return std::uint32_t Key that is passed to counterRandom
+ */
+inline std::uint32_t randomKey(std::uint32_t seed, std::uint32_t stream)
+{
+	return hash32(seed ^ hash32(stream + 0x9E3779B9u));
+}
+
+/**
+ * @brief Get a random number that only depends on a key and a counter, not on any state
+ *
+ * The same key and counter always give the same number, no matter in which order or on which thread the numbers
+ * are drawn, and different counters of one key never give the same number.
+ *
+ * @param key Key of the stream, from randomKey
+ * @param counter Counter in the stream, for example the index of an entity
+ * @return std::uint32_t Random number
+ */
+inline std::uint32_t counterRandom(std::uint32_t key, std::uint32_t counter)
+{
+	return hash32(counter ^ key);
+}
+}
+
+#endif // UTIL_COUNTER_RANDOM_HPP
@@ -0,0 +1,150 @@
+#ifndef UTIL_MAPPED_FILE_HPP
+#define UTIL_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif // _WIN32
+
+namespace util
+{
+/**
+ * @brief Private mapping of a whole file into memory
+ *
+ * The pages are read from the file when they are first touched. They can be written, but the writes are copied on
+ * write and never reach the file, so the file can be mapped again later.
+ *
+ */
+struct MappedFile
+{
+	/**
+	 * @brief Construct a new Mapped File object that maps nothing
+	 *
+	 */
+	MappedFile() = default;
+
+	/**
+	 * @brief The mapping is released once, so it can not be copied
+	 *
+	 */
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/**
+	 * @brief Destroy the Mapped File object and release the mapping
+	 *
+	 */
+	~MappedFile()
+	{
+		close();
+	}
+
+	/**
+	 * @brief Map a file, releasing the previous mapping
+	 *
+	 * @param path Path of the file
+	 * @return true True if the whole file is mapped
+	 * @return false False if the file could not be opened or is empty
+	 */
+	bool open(const std::string& path)
+	{
+		close();
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		LARGE_INTEGER fileSize;
+		HANDLE mapping = nullptr;
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+		{
+			mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+		}
+		if (mapping != nullptr)
+		{
+			bytes = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+			length = bytes != nullptr ? size_t(fileSize.QuadPart) : 0;
+			CloseHandle(mapping);
+		}
+		CloseHandle(file);
+#else
+		int file = ::open(path.c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			return false;
+		}
+		struct stat status;
+		if (fstat(file, &status) == 0 && status.st_size > 0)
+		{
+			void* mapped = mmap(nullptr, size_t(status.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+			if (mapped != MAP_FAILED)
+			{
+				bytes = static_cast<char*>(mapped);
+				length = size_t(status.st_size);
+			}
+		}
+		::close(file);
+#endif // _WIN32
+		return bytes != nullptr;
+	}
+
+	/**
+	 * @brief Release the mapping. Pointers into it become invalid
+	 *
+	 */
+	void close()
+	{
+		if (bytes == nullptr)
+		{
+			return;
+		}
+#ifdef _WIN32
+		UnmapViewOfFile(bytes);
+#else
+		munmap(bytes, length);
+#endif // _WIN32
+		bytes = nullptr;
+		length = 0;
+	}
+
+	/**
+	 * @brief Get the mapped bytes
+	 *
+	 * @return char* First byte of the file, null if nothing is mapped
+	 */
+	inline char* data() const
+	{
+		return bytes;
+	}
+
+	/**
+	 * @brief Get the number of mapped bytes
+	 *
+	 * @return size_t Size of the file
+	 */
+	inline size_t size() const
+	{
+		return length;
+	}
+
+	/**
+	 * @brief First byte of the mapping, null if nothing is mapped
+	 *
+	 */
+	char* bytes { nullptr };
+
+	/**
+	 * @brief Number of mapped bytes
+	 *
+	 */
+	size_t length { 0 };
+};
+}
+
+#endif // UTIL_MAPPED_FILE_HPP
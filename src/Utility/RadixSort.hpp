@@ -0,0 +1,59 @@
+#ifndef UTIL_RADIX_SORT_HPP
+#define UTIL_RADIX_SORT_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace util
+{
+/**
+ * @brief Stable least significant digit radix sort by an unsigned 32 bit key, one byte per pass
+ *
+ * Passes in which all items share the same byte are skipped, so small keys only need one or two passes.
+ *
+ * @tparam Item Type of the sorted items. Must have a std::uint32_t member called key
+ * @param items Items that will be sorted
+ * @param scratch Buffer of the same type, reused between calls to avoid allocations
+ */
+template <typename Item>
+void radixSort(std::vector<Item>& items, std::vector<Item>& scratch)
+{
+	// Count all four digits in one pass over the items
+	std::uint32_t counts[4][256] = {};
+	for (const Item& item : items)
+	{
+		counts[0][item.key & 0xFF]++;
+		counts[1][(item.key >> 8) & 0xFF]++;
+		counts[2][(item.key >> 16) & 0xFF]++;
+		counts[3][item.key >> 24]++;
+	}
+
+	scratch.resize(items.size());
+	for (int pass = 0; pass < 4; pass++)
+	{
+		// All items have the same digit, so this pass would not change the order
+		std::uint32_t* count = counts[pass];
+		if (items.empty() || count[(items.front().key >> (pass * 8)) & 0xFF] == items.size())
+		{
+			continue;
+		}
+
+		// Turn the counts into the first slot of each digit
+		std::uint32_t offset = 0;
+		for (int digit = 0; digit < 256; digit++)
+		{
+			std::uint32_t size = count[digit];
+			count[digit] = offset;
+			offset += size;
+		}
+
+		for (const Item& item : items)
+		{
+			scratch[count[(item.key >> (pass * 8)) & 0xFF]++] = item;
+		}
+		items.swap(scratch);
+	}
+}
+}
+
+#endif // UTIL_RADIX_SORT_HPP
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "ecs/Util.hpp"
+
 /**
  * @brief Collision component
  *
@@ -11,4 +13,14 @@ struct Collision
 	 *
 	 */
 	int damage;
+};
+
+/**
+ * @brief Collisions are assigned and removed every frame, so they are stored in a sparse set
+ *
+ */
+template <>
+struct ComponentStorage<Collision>
+{
+	static constexpr StorageType type = StorageType::SparseSet;
 };
\ No newline at end of file
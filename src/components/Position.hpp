@@ -1,5 +1,7 @@
 #pragma once
 
+#include "ecs/ComponentFields.hpp"
+
 /**
  * @brief Position component
  *
@@ -17,4 +19,10 @@ struct Position
 	 *
 	 */
 	int y;
-};
\ No newline at end of file
+};
+
+/**
+ * @brief Positions are read field by field for many entities at once, so each field is stored in its own array
+ *
+ */
+SOA_FIELDS(Position, x, y)
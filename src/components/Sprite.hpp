@@ -1,14 +1,34 @@
 #pragma once
 
+#include <cstdint>
+#include <type_traits>
+
 /**
  * @brief Sprite component
  *
+ * Only holds what differs between entities. The shape itself is shared by all sprites of the same kind, in the
+ * shape table of the render system.
+ *
  */
 struct Sprite
 {
 	/**
-	 * @brief Shape of the sprite
+	 * @brief Fill color of the sprite
+	 *
+	 */
+	sf::Color color { sf::Color::White };
+
+	/**
+	 * @brief Radius of the sprite in pixels
 	 *
 	 */
-	sf::CircleShape shape;
-};
\ No newline at end of file
+	std::uint16_t radius { 1 };
+
+	/**
+	 * @brief Index of the shape of the sprite in the shape table of the render system
+	 *
+	 */
+	std::uint8_t shape { 0 };
+};
+
+static_assert(std::is_trivially_copyable<Sprite>::value && sizeof(Sprite) <= 8, "Sprite is stored like any plain component");
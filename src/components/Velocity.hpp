@@ -1,4 +1,7 @@
 #pragma once
+
+#include "ecs/ComponentFields.hpp"
+
 /**
  * @brief Velocity component
  *
@@ -16,4 +19,10 @@ struct Velocity
 	 *
 	 */
 	int y;
-};
\ No newline at end of file
+};
+
+/**
+ * @brief The movement system adds the velocities to the positions of all entities, so they are stored field by field as well
+ *
+ */
+SOA_FIELDS(Velocity, x, y)
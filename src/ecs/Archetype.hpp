@@ -0,0 +1,581 @@
+#pragma once
+
+#include "ecs/Util.hpp"
+#include <array>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Number of entities stored in one chunk of an archetype table
+ *
+ */
+const size_t ARCHETYPE_CHUNK_ROWS = 1024;
+
+/**
+ * @brief Type information of a component, used to construct, move and destroy components without knowing their type
+ *
+ */
+struct ComponentInfo
+{
+	/**
+	 * @brief Size of one component
+	 *
+	 */
+	size_t size { 0 };
+
+	/**
+	 * @brief Alignment of one component
+	 *
+	 */
+	size_t align { 1 };
+
+	/**
+	 * @brief Default construct a component at the specified address
+	 *
+	 */
+	void (*construct)(void* dst) { nullptr };
+
+	/**
+	 * @brief Move construct a component at the specified address from another component
+	 *
+	 */
+	void (*move)(void* dst, void* src) { nullptr };
+
+	/**
+	 * @brief Destroy the component at the specified address
+	 *
+	 */
+	void (*destroy)(void* dst) { nullptr };
+};
+
+/**
+ * @brief Create the type information of a component
+ *
+ * @tparam T Type of the component
+ * @return ComponentInfo Type information of the component
+ */
+template <typename T>
+ComponentInfo MakeComponentInfo()
+{
+	ComponentInfo info;
+	info.size = sizeof(T);
+	info.align = alignof(T);
+	info.construct = [](void* dst) { new (dst) T(); };
+	info.move = [](void* dst, void* src) { new (dst) T(std::move(*static_cast<T*>(src))); };
+	info.destroy = [](void* dst) { static_cast<T*>(dst)->~T(); };
+	return info;
+}
+
+/**
+ * @brief Table that stores all entities with the same component mask, with one column per component type
+ *
+ * The rows are split into chunks of ARCHETYPE_CHUNK_ROWS entities. Inside a chunk every column is a contiguous array.
+ * Removing a row moves the last row into its place, so the table stays packed.
+ *
+ */
+struct Archetype
+{
+	/**
+	 * @brief Construct a new Archetype object
+	 *
+	 * @param mask Components of the entities stored in this table
+	 * @param infos Type information of all registered components, indexed by component ID
+	 */
+	Archetype(const ComponentMask& mask, const std::vector<ComponentInfo>& infos) :
+		mask(mask)
+	{
+		columnOf.fill(-1);
+		addEdges.fill(-1);
+		removeEdges.fill(-1);
+
+		// The entity IDs are stored in front of the component columns
+		chunkSize = sizeof(EntityID) * ARCHETYPE_CHUNK_ROWS;
+		for (int componentId = 0; componentId < MAX_COMPONENTS; componentId++)
+		{
+			if (!mask.test(componentId))
+			{
+				continue;
+			}
+
+			const ComponentInfo& info = infos[componentId];
+			chunkSize = (chunkSize + info.align - 1) / info.align * info.align;
+			columnOf[componentId] = int(columns.size());
+			columns.push_back({ componentId, chunkSize, info });
+			chunkSize += info.size * ARCHETYPE_CHUNK_ROWS;
+		}
+	}
+
+	/**
+	 * @brief The table owns its chunks and can therefore not be copied
+	 *
+	 */
+	Archetype(const Archetype&) = delete;
+	Archetype& operator=(const Archetype&) = delete;
+
+	/**
+	 * @brief Destroy the Archetype object and all components that are stored in it
+	 *
+	 */
+	~Archetype()
+	{
+		while (count > 0)
+		{
+			RemoveRow(count - 1);
+		}
+		for (char* chunk : chunks)
+		{
+			delete[] chunk;
+		}
+	}
+
+	/**
+	 * @brief Get the component in the specified row and column
+	 *
+	 * @param row Row of the entity
+	 * @param column Column of the component type
+	 * @return void* Pointer to the component
+	 */
+	inline void* Get(size_t row, int column)
+	{
+		return Column(row / ARCHETYPE_CHUNK_ROWS, column) + (row % ARCHETYPE_CHUNK_ROWS) * columns[column].info.size;
+	}
+
+	/**
+	 * @brief Get the ID of the entity in the specified row
+	 *
+	 * @param row Row of the entity
+	 * @return EntityID& ID of the entity
+	 */
+	inline EntityID& EntityAt(size_t row)
+	{
+		return Entities(row / ARCHETYPE_CHUNK_ROWS)[row % ARCHETYPE_CHUNK_ROWS];
+	}
+
+	/**
+	 * @brief Get the start of a column in the specified chunk
+	 *
+	 * @param chunk Index of the chunk
+	 * @param column Column of the component type
+	 * @return char* Start of the column
+	 */
+	inline char* Column(size_t chunk, int column)
+	{
+		return chunks[chunk] + columns[column].offset;
+	}
+
+	/**
+	 * @brief Get the IDs of the entities in the specified chunk
+	 *
+	 * @param chunk Index of the chunk
+	 * @return EntityID* IDs of the entities
+	 */
+	inline EntityID* Entities(size_t chunk)
+	{
+		return reinterpret_cast<EntityID*>(chunks[chunk]);
+	}
+
+	/**
+	 * @brief Get the number of rows that are in use in the specified chunk
+	 *
+	 * @param chunk Index of the chunk
+	 * @return size_t Number of rows
+	 */
+	inline size_t RowsInChunk(size_t chunk) const
+	{
+		return std::min(ARCHETYPE_CHUNK_ROWS, count - chunk * ARCHETYPE_CHUNK_ROWS);
+	}
+
+	/**
+	 * @brief Get the number of chunks that contain at least one row
+	 *
+	 * @return size_t Number of chunks
+	 */
+	inline size_t ChunkCount() const
+	{
+		return (count + ARCHETYPE_CHUNK_ROWS - 1) / ARCHETYPE_CHUNK_ROWS;
+	}
+
+	/**
+	 * @brief Add a row for the specified entity. The components of the row are not constructed
+	 *
+	 * @param id ID of the entity
+	 * @return size_t Row of the entity
+	 */
+	size_t AddRow(EntityID id)
+	{
+		if (count == chunks.size() * ARCHETYPE_CHUNK_ROWS)
+		{
+			chunks.push_back(new char[chunkSize]);
+		}
+		EntityAt(count) = id;
+		return count++;
+	}
+
+	/**
+	 * @brief Destroy the components of a row and move the last row into its place
+	 *
+	 * @param row Row that will be removed
+	 * @return EntityID ID of the entity that was moved into the row, invalid if no entity was moved
+	 */
+	EntityID RemoveRow(size_t row)
+	{
+		size_t last = count - 1;
+		EntityID moved = INVALID_ENTITY;
+		for (int column = 0; column < columns.size(); column++)
+		{
+			const ComponentInfo& info = columns[column].info;
+			info.destroy(Get(row, column));
+			if (row != last)
+			{
+				info.move(Get(row, column), Get(last, column));
+				info.destroy(Get(last, column));
+			}
+		}
+		if (row != last)
+		{
+			moved = EntityAt(last);
+			EntityAt(row) = moved;
+		}
+		count--;
+		return moved;
+	}
+
+	/**
+	 * @brief Column of a component type inside a chunk
+	 *
+	 */
+	struct ColumnInfo
+	{
+		/**
+		 * @brief ID of the component type
+		 *
+		 */
+		int componentId;
+
+		/**
+		 * @brief Byte offset of the column inside a chunk
+		 *
+		 */
+		size_t offset;
+
+		/**
+		 * @brief Type information of the component
+		 *
+		 */
+		ComponentInfo info;
+	};
+
+	/**
+	 * @brief Components of the entities stored in this table
+	 *
+	 */
+	ComponentMask mask;
+
+	/**
+	 * @brief Columns of this table, ordered by component ID
+	 *
+	 */
+	std::vector<ColumnInfo> columns;
+
+	/**
+	 * @brief Column of each component ID, -1 if the component is not part of this table
+	 *
+	 */
+	std::array<int, MAX_COMPONENTS> columnOf;
+
+	/**
+	 * @brief Table that entities move to when a component is added, -1 if not looked up yet
+	 *
+	 */
+	std::array<int, MAX_COMPONENTS> addEdges;
+
+	/**
+	 * @brief Table that entities move to when a component is removed, -1 if not looked up yet
+	 *
+	 */
+	std::array<int, MAX_COMPONENTS> removeEdges;
+
+	/**
+	 * @brief Chunks that hold the entity IDs and the component columns
+	 *
+	 */
+	std::vector<char*> chunks;
+
+	/**
+	 * @brief Size of one chunk in bytes
+	 *
+	 */
+	size_t chunkSize { 0 };
+
+	/**
+	 * @brief Number of entities stored in this table
+	 *
+	 */
+	size_t count { 0 };
+};
+
+/**
+ * @brief Storage that keeps entities in archetype tables, grouped by their component mask
+ *
+ */
+struct ArchetypeStorage
+{
+	/**
+	 * @brief Location of an entity inside the archetype tables
+	 *
+	 */
+	struct EntityLocation
+	{
+		/**
+		 * @brief Table of the entity, -1 if the entity has no components
+		 *
+		 */
+		int archetype { -1 };
+
+		/**
+		 * @brief Row of the entity inside its table
+		 *
+		 */
+		size_t row { 0 };
+	};
+
+	/**
+	 * @brief Construct a new Archetype Storage object
+	 *
+	 */
+	ArchetypeStorage() = default;
+
+	/**
+	 * @brief The storage owns its tables and can therefore not be copied
+	 *
+	 */
+	ArchetypeStorage(const ArchetypeStorage&) = delete;
+	ArchetypeStorage& operator=(const ArchetypeStorage&) = delete;
+
+	/**
+	 * @brief Destroy the Archetype Storage object and all of its tables
+	 *
+	 */
+	~ArchetypeStorage()
+	{
+		for (Archetype* archetype : archetypes)
+		{
+			delete archetype;
+		}
+	}
+
+	/**
+	 * @brief Register the type information of a component, so it can be moved between tables
+	 *
+	 * @tparam T Type of the component
+	 */
+	template <typename T>
+	void Register()
+	{
+		int componentId = GetId<T>();
+		if (infos.size() <= componentId)
+		{
+			infos.resize(componentId + 1);
+		}
+		if (infos[componentId].size == 0)
+		{
+			infos[componentId] = MakeComponentInfo<T>();
+		}
+	}
+
+	/**
+	 * @brief Get the component of the specified entity. The entity must have the component
+	 *
+	 * @param index Index of the entity
+	 * @param componentId ID of the component type
+	 * @return void* Pointer to the component
+	 */
+	inline void* Get(EntityIndex index, int componentId)
+	{
+		const EntityLocation& location = locations[index];
+		Archetype* archetype = archetypes[location.archetype];
+		return archetype->Get(location.row, archetype->columnOf[componentId]);
+	}
+
+	/**
+	 * @brief Add a component to an entity by moving the entity into the table of its new mask
+	 *
+	 * @param id ID of the entity
+	 * @param mask Current components of the entity
+	 * @param componentId ID of the added component type, which must be registered
+	 * @return void* Pointer to the default constructed component
+	 */
+	void* Add(EntityID id, const ComponentMask& mask, int componentId)
+	{
+		EntityIndex index = GetEntityIndex(id);
+		if (locations.size() <= index)
+		{
+			locations.resize(index + 1);
+		}
+
+		// Replace the component if the entity already has it
+		if (mask.test(componentId))
+		{
+			void* component = Get(index, componentId);
+			infos[componentId].destroy(component);
+			infos[componentId].construct(component);
+			return component;
+		}
+
+		int source = locations[index].archetype;
+		int target = source == -1 ? FindArchetype(ComponentMask().set(componentId)) : FindEdge(source, componentId, true);
+		MoveEntity(id, target);
+
+		Archetype* archetype = archetypes[target];
+		void* component = archetype->Get(locations[index].row, archetype->columnOf[componentId]);
+		infos[componentId].construct(component);
+		return component;
+	}
+
+	/**
+	 * @brief Remove a component from an entity by moving the entity into the table of its new mask
+	 *
+	 * @param id ID of the entity
+	 * @param mask Current components of the entity
+	 * @param componentId ID of the removed component type
+	 */
+	void Remove(EntityID id, const ComponentMask& mask, int componentId)
+	{
+		if (!mask.test(componentId))
+		{
+			return;
+		}
+
+		EntityIndex index = GetEntityIndex(id);
+		int source = locations[index].archetype;
+		if (mask.count() == 1)
+		{
+			RemoveEntity(index);
+			return;
+		}
+		MoveEntity(id, FindEdge(source, componentId, false));
+	}
+
+	/**
+	 * @brief Remove an entity and destroy all of its components
+	 *
+	 * @param index Index of the entity
+	 */
+	void RemoveEntity(EntityIndex index)
+	{
+		if (locations.size() <= index || locations[index].archetype == -1)
+		{
+			return;
+		}
+
+		EntityLocation& location = locations[index];
+		EntityID moved = archetypes[location.archetype]->RemoveRow(location.row);
+		if (IsEntityValid(moved))
+		{
+			locations[GetEntityIndex(moved)].row = location.row;
+		}
+		location.archetype = -1;
+	}
+
+	/**
+	 * @brief Move an entity into another table. Components of both tables are moved, new ones are left unconstructed
+	 *
+	 * @param id ID of the entity
+	 * @param target Table the entity is moved to
+	 */
+	void MoveEntity(EntityID id, int target)
+	{
+		EntityIndex index = GetEntityIndex(id);
+		EntityLocation& location = locations[index];
+		Archetype* to = archetypes[target];
+		size_t row = to->AddRow(id);
+
+		if (location.archetype != -1)
+		{
+			// Move the shared components, the old row is destroyed when it is removed from its table
+			Archetype* from = archetypes[location.archetype];
+			for (const Archetype::ColumnInfo& column : from->columns)
+			{
+				int toColumn = to->columnOf[column.componentId];
+				if (toColumn != -1)
+				{
+					column.info.move(to->Get(row, toColumn), from->Get(location.row, from->columnOf[column.componentId]));
+				}
+			}
+			RemoveEntity(index);
+		}
+
+		location.archetype = target;
+		location.row = row;
+	}
+
+	/**
+	 * @brief Get the table that entities move to when a component is added to or removed from a table
+	 *
+	 * @param source Table the entity is currently stored in
+	 * @param componentId ID of the component type
+	 * @param add True if the component is added, false if it is removed
+	 * @return int Table the entity moves to
+	 */
+	int FindEdge(int source, int componentId, bool add)
+	{
+		std::array<int, MAX_COMPONENTS>& edges = add ? archetypes[source]->addEdges : archetypes[source]->removeEdges;
+		if (edges[componentId] == -1)
+		{
+			ComponentMask mask = archetypes[source]->mask;
+			mask.set(componentId, add);
+			int target = FindArchetype(mask);
+
+			// Looking up the table may have added a new one, so the edges are accessed again
+			(add ? archetypes[source]->addEdges : archetypes[source]->removeEdges)[componentId] = target;
+			return target;
+		}
+		return edges[componentId];
+	}
+
+	/**
+	 * @brief Get the table for the specified mask, creating it if it does not exist yet
+	 *
+	 * @param mask Components of the table
+	 * @return int Index of the table
+	 */
+	int FindArchetype(const ComponentMask& mask)
+	{
+		auto it = lookup.find(mask);
+		if (it != lookup.end())
+		{
+			return it->second;
+		}
+
+		int index = int(archetypes.size());
+		archetypes.push_back(new Archetype(mask, infos));
+		lookup.emplace(mask, index);
+		return index;
+	}
+
+	/**
+	 * @brief All tables, in the order in which they were created
+	 *
+	 */
+	std::vector<Archetype*> archetypes;
+
+	/**
+	 * @brief Table of each component mask
+	 *
+	 */
+	std::unordered_map<ComponentMask, int> lookup;
+
+	/**
+	 * @brief Location of each entity, indexed by the entity index
+	 *
+	 */
+	std::vector<EntityLocation> locations;
+
+	/**
+	 * @brief Type information of the registered components, indexed by the component ID
+	 *
+	 */
+	std::vector<ComponentInfo> infos;
+};
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#include <immintrin.h>
+	#define BITMAP_AVX2
+#endif
+
+/**
+ * @brief Number of 64 bit words that are checked at once when searching bitmaps. Bitmaps are padded to whole blocks
+ *
+ */
+const size_t BITMAP_BLOCK_WORDS = 4;
+
+/**
+ * @brief Get the index of the lowest set bit
+ *
+ * @param bits Bits, at least one must be set
+ * @return unsigned int Index of the lowest set bit
+ */
+inline unsigned int LowestBit(std::uint64_t bits)
+{
+#if defined(__GNUC__)
+	return unsigned(__builtin_ctzll(bits));
+#else
+	unsigned int bit = 0;
+	while ((bits & 1) == 0)
+	{
+		bits >>= 1;
+		bit++;
+	}
+	return bit;
+#endif
+}
+
+/**
+ * @brief Intersect one word of several bitmaps
+ *
+ * @param bitmaps Bitmaps that are intersected
+ * @param count Number of bitmaps
+ * @param word Index of the word
+ * @return std::uint64_t Bits that are set in all bitmaps
+ */
+inline std::uint64_t AndWord(const std::uint64_t* const* bitmaps, size_t count, size_t word)
+{
+	std::uint64_t bits = bitmaps[0][word];
+	for (size_t i = 1; i < count; i++)
+	{
+		bits &= bitmaps[i][word];
+	}
+	return bits;
+}
+
+/**
+ * @brief Check if a bit is set in all bitmaps somewhere in one block
+ *
+ * @param bitmaps Bitmaps that are intersected
+ * @param count Number of bitmaps
+ * @param word Index of the first word of the block
+ * @return true True if the intersection of the block is not empty
+ * @return false False if the intersection of the block is empty
+ */
+inline bool AnyInBlockScalar(const std::uint64_t* const* bitmaps, size_t count, size_t word)
+{
+	std::uint64_t bits = 0;
+	for (size_t i = 0; i < BITMAP_BLOCK_WORDS; i++)
+	{
+		bits |= AndWord(bitmaps, count, word + i);
+	}
+	return bits != 0;
+}
+
+#ifdef BITMAP_AVX2
+/**
+ * @brief Check if a bit is set in all bitmaps somewhere in one block, 256 bits at a time
+ *
+ * @param bitmaps Bitmaps that are intersected
+ * @param count Number of bitmaps
+ * @param word Index of the first word of the block
+ * @return true True if the intersection of the block is not empty
+ * @return false False if the intersection of the block is empty
+ */
+__attribute__((target("avx2"))) inline bool AnyInBlockAvx2(const std::uint64_t* const* bitmaps, size_t count, size_t word)
+{
+	__m256i bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bitmaps[0] + word));
+	for (size_t i = 1; i < count; i++)
+	{
+		bits = _mm256_and_si256(bits, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bitmaps[i] + word)));
+	}
+	return !_mm256_testz_si256(bits, bits);
+}
+#endif
+
+/**
+ * @brief Check if a bit is set in all bitmaps somewhere in one block, with AVX2 if the CPU supports it
+ *
+ * @param bitmaps Bitmaps that are intersected
+ * @param count Number of bitmaps
+ * @param word Index of the first word of the block
+ * @return true True if the intersection of the block is not empty
+ * @return false False if the intersection of the block is empty
+ */
+inline bool AnyInBlock(const std::uint64_t* const* bitmaps, size_t count, size_t word)
+{
+#ifdef BITMAP_AVX2
+	static const bool avx2 = __builtin_cpu_supports("avx2");
+	if (avx2)
+	{
+		return AnyInBlockAvx2(bitmaps, count, word);
+	}
+#endif
+	return AnyInBlockScalar(bitmaps, count, word);
+}
+
+/**
+ * @brief Find the next bit that is set in all bitmaps. Blocks in which no bit is set in all bitmaps are skipped
+ *
+ * @param bitmaps Bitmaps that are intersected. Must be padded to whole blocks
+ * @param count Number of bitmaps, at least one
+ * @param from First bit that is checked
+ * @param end End of the checked bits
+ * @return size_t Index of the next set bit, end if there is none
+ */
+inline size_t NextSetBit(const std::uint64_t* const* bitmaps, size_t count, size_t from, size_t end)
+{
+	size_t words = (end + 63) >> 6;
+	size_t word = from >> 6;
+	if (from >= end)
+	{
+		return end;
+	}
+
+	std::uint64_t bits = AndWord(bitmaps, count, word) & (~std::uint64_t(0) << (from & 63));
+	while (bits == 0)
+	{
+		word++;
+		while (word % BITMAP_BLOCK_WORDS == 0 && word < words && !AnyInBlock(bitmaps, count, word))
+		{
+			word += BITMAP_BLOCK_WORDS;
+		}
+		if (word >= words)
+		{
+			return end;
+		}
+		bits = AndWord(bitmaps, count, word);
+	}
+
+	size_t bit = (word << 6) + LowestBit(bits);
+	return bit < end ? bit : end;
+}
\ No newline at end of file
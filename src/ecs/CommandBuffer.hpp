@@ -0,0 +1,222 @@
+#pragma once
+
+#include "ecs/ComponentFields.hpp"
+#include "ecs/Util.hpp"
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+struct Scene;
+
+/**
+ * @brief Buffer of structural changes that are recorded while iterating and applied to a scene later
+ *
+ * Recording never touches the scene, so it is safe while scene views are iterated, also from several threads
+ * with one buffer each. Scene::Playback applies the changes of all buffers sorted by entity index.
+ *
+ */
+struct CommandBuffer
+{
+	/**
+	 * @brief Marker for commands without a value
+	 *
+	 */
+	static constexpr std::uint32_t NO_VALUE = std::uint32_t(-1);
+
+	/**
+	 * @brief Recorded change of one entity
+	 *
+	 */
+	struct Command
+	{
+		/**
+		 * @brief Index of the entity, which the commands are sorted by. Entities that are created sort last
+		 *
+		 */
+		std::uint32_t key;
+
+		/**
+		 * @brief Buffer that holds the value of the command, set when the commands are played back
+		 *
+		 */
+		std::uint32_t buffer;
+
+		/**
+		 * @brief Offset of the value in the values of the buffer, or the created entity in its creates
+		 *
+		 */
+		std::uint32_t value;
+
+		/**
+		 * @brief ID of the entity
+		 *
+		 */
+		EntityID id;
+
+		/**
+		 * @brief Function that applies the command, null if the command creates an entity
+		 *
+		 */
+		void (*apply)(Scene& scene, EntityID id, const void* value);
+	};
+
+	/**
+	 * @brief Record the creation of an entity
+	 *
+	 * @param init Function that is called with the new entity once it was created, can be empty
+	 */
+	void Create(std::function<void(Scene&, EntityID)> init = nullptr)
+	{
+		commands.push_back({ std::uint32_t(-1), 0, std::uint32_t(creates.size()), INVALID_ENTITY, nullptr });
+		creates.push_back(std::move(init));
+	}
+
+	/**
+	 * @brief Record the destruction of an entity
+	 *
+	 * @param id ID of the entity
+	 */
+	void Destroy(EntityID id)
+	{
+		commands.push_back({ GetEntityIndex(id), 0, NO_VALUE, id, &DestroyIn });
+	}
+
+	/**
+	 * @brief Record the assignment of a default constructed component
+	 *
+	 * @tparam T Type of the component
+	 * @param id ID of the entity
+	 */
+	template <typename T>
+	void Assign(EntityID id)
+	{
+		commands.push_back({ GetEntityIndex(id), 0, NO_VALUE, id, &AssignIn<T, Scene> });
+	}
+
+	/**
+	 * @brief Record the assignment of a component with a value
+	 *
+	 * @tparam T Type of the component. Must be trivially copyable, since the value is stored as bytes
+	 * @param id ID of the entity
+	 * @param value Value of the component
+	 */
+	template <typename T>
+	void Assign(EntityID id, const T& value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable components can be recorded with a value");
+		std::uint32_t offset = std::uint32_t(values.size());
+		values.resize(values.size() + sizeof(T));
+		std::memcpy(&values[offset], &value, sizeof(T));
+		commands.push_back({ GetEntityIndex(id), 0, offset, id, &AssignIn<T, Scene> });
+	}
+
+	/**
+	 * @brief Record the removal of a component
+	 *
+	 * @tparam T Type of the component
+	 * @param id ID of the entity
+	 */
+	template <typename T>
+	void Remove(EntityID id)
+	{
+		commands.push_back({ GetEntityIndex(id), 0, NO_VALUE, id, &RemoveIn<T, Scene> });
+	}
+
+	/**
+	 * @brief Check if no command was recorded
+	 *
+	 * @return true True if the buffer is empty
+	 * @return false False if commands were recorded
+	 */
+	inline bool Empty() const
+	{
+		return commands.empty();
+	}
+
+	/**
+	 * @brief Forget all recorded commands
+	 *
+	 */
+	void Clear()
+	{
+		commands.clear();
+		values.clear();
+		creates.clear();
+	}
+
+	/**
+	 * @brief Destroy an entity. Defined in Scene.hpp, where the scene is complete
+	 *
+	 * @param scene Scene that holds the entity
+	 * @param id ID of the entity
+	 * @param value Unused
+	 */
+	static void DestroyIn(Scene& scene, EntityID id, const void* value);
+
+	/**
+	 * @brief Assign a component and copy the recorded value into it, if there is one
+	 *
+	 * The scene is a template parameter, so it only has to be complete where a component type is recorded.
+	 *
+	 * @tparam T Type of the component
+	 * @tparam SceneType Type of the scene
+	 * @param scene Scene that holds the entity
+	 * @param id ID of the entity
+	 * @param value Recorded value of the component, can be null
+	 */
+	template <typename T, typename SceneType>
+	static void AssignIn(SceneType& scene, EntityID id, const void* value)
+	{
+		ComponentPtr<T> component = scene.template Assign<T>(id);
+		if constexpr (IsSoA<T>)
+		{
+			// The fields are scattered over their arrays
+			if (value != nullptr)
+			{
+				*component = *static_cast<const T*>(value);
+			}
+		}
+		else if constexpr (std::is_trivially_copyable<T>::value)
+		{
+			if (value != nullptr)
+			{
+				std::memcpy(component, value, sizeof(T));
+			}
+		}
+	}
+
+	/**
+	 * @brief Remove a component
+	 *
+	 * @tparam T Type of the component
+	 * @tparam SceneType Type of the scene
+	 * @param scene Scene that holds the entity
+	 * @param id ID of the entity
+	 * @param value Unused
+	 */
+	template <typename T, typename SceneType>
+	static void RemoveIn(SceneType& scene, EntityID id, const void* value)
+	{
+		scene.template Remove<T>(id);
+	}
+
+	/**
+	 * @brief Commands in the order they were recorded
+	 *
+	 */
+	std::vector<Command> commands;
+
+	/**
+	 * @brief Values of the recorded components
+	 *
+	 */
+	std::vector<unsigned char> values;
+
+	/**
+	 * @brief Functions that initialize the created entities
+	 *
+	 */
+	std::vector<std::function<void(Scene&, EntityID)>> creates;
+};
\ No newline at end of file
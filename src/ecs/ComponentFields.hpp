@@ -0,0 +1,271 @@
+#pragma once
+
+#include "ecs/Util.hpp"
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+
+/**
+ * @brief Fields of a component type that is stored as structure of arrays. Specialized with SOA_FIELDS
+ *
+ * The specialization holds the number of fields, a Ref type with one reference member per field, named like the
+ * fields of the component, and Bind, which gets the references to the fields of a component object.
+ *
+ * @tparam T Type of the component
+ */
+template <class T>
+struct ComponentFields;
+
+/**
+ * @brief Index of a field of a component, used to pick the field at compile time
+ *
+ * @tparam I Index of the field, in the order the fields are listed in SOA_FIELDS
+ */
+template <std::size_t I>
+using FieldIndex = std::integral_constant<std::size_t, I>;
+
+/**
+ * @brief Check if a component type is stored as structure of arrays
+ *
+ * @tparam T Type of the component
+ */
+template <class T>
+constexpr bool IsSoA = ComponentStorage<T>::type == StorageType::SoA;
+
+/**
+ * @brief Selects how the components of a type are referenced, by plain references or by references to their fields
+ *
+ * @tparam T Type of the component
+ * @tparam SoA Flag if the type is stored as structure of arrays
+ */
+template <class T, bool SoA = IsSoA<T>>
+struct ComponentAccess
+{
+	typedef T& Ref;
+	typedef T* Ptr;
+};
+
+/**
+ * @brief Pointer to a component whose fields are stored in separate arrays
+ *
+ * Holds the references to the fields, so the fields are accessed with -> like through a plain pointer.
+ *
+ * @tparam T Type of the component
+ */
+template <class T>
+struct SoaPtr
+{
+	typedef typename ComponentFields<T>::Ref Ref;
+
+	/**
+	 * @brief Construct a null pointer
+	 *
+	 */
+	SoaPtr(std::nullptr_t = nullptr)
+	{
+	}
+
+	/**
+	 * @brief Construct a pointer to the fields of a component
+	 *
+	 * @param ref References to the fields
+	 */
+	SoaPtr(const Ref& ref) :
+		ref(ref)
+	{
+	}
+
+	/**
+	 * @brief Construct a pointer to a component object, as stored in archetype tables
+	 *
+	 * @param component Pointer to the component, can be null
+	 */
+	SoaPtr(T* component)
+	{
+		if (component != nullptr)
+		{
+			ref.emplace(ComponentFields<T>::Bind(*component));
+		}
+	}
+
+	/**
+	 * @brief The references can not be reseated, so assigning another pointer rebinds them
+	 *
+	 * @param other Pointer that is copied
+	 * @return SoaPtr& This pointer
+	 */
+	SoaPtr(const SoaPtr& other) = default;
+	SoaPtr& operator=(const SoaPtr& other)
+	{
+		ref.reset();
+		if (other.ref)
+		{
+			ref.emplace(*other.ref);
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Member access operator. The fields stay writable, because they are held by reference
+	 *
+	 * @return const Ref* References to the fields
+	 */
+	inline const Ref* operator->() const
+	{
+		return &*ref;
+	}
+
+	/**
+	 * @brief Dereference operator
+	 *
+	 * @return const Ref& References to the fields
+	 */
+	inline const Ref& operator*() const
+	{
+		return *ref;
+	}
+
+	/**
+	 * @brief Get the address of the first field, which identifies the component
+	 *
+	 * @return const void* Address of the first field, null for a null pointer
+	 */
+	inline const void* Address() const
+	{
+		return ref ? &ref->Field(FieldIndex<0>()) : nullptr;
+	}
+
+	inline bool operator==(const SoaPtr& other) const
+	{
+		return Address() == other.Address();
+	}
+
+	inline bool operator!=(const SoaPtr& other) const
+	{
+		return Address() != other.Address();
+	}
+
+	inline bool operator==(std::nullptr_t) const
+	{
+		return !ref;
+	}
+
+	inline bool operator!=(std::nullptr_t) const
+	{
+		return bool(ref);
+	}
+
+	inline explicit operator bool() const
+	{
+		return bool(ref);
+	}
+
+	/**
+	 * @brief References to the fields, empty for a null pointer
+	 *
+	 */
+	std::optional<Ref> ref;
+};
+
+template <class T>
+struct ComponentAccess<T, true>
+{
+	typedef typename ComponentFields<T>::Ref Ref;
+	typedef SoaPtr<T> Ptr;
+};
+
+/**
+ * @brief Reference to a component, as passed to the functions of SceneView::ForEach. For structure of arrays
+ * components this is a small object of references to the fields, so systems access the fields the same way
+ *
+ * @tparam T Type of the component
+ */
+template <class T>
+using ComponentRef = typename ComponentAccess<T>::Ref;
+
+/**
+ * @brief Pointer to a component, as returned by Scene::Get and Scene::Assign
+ *
+ * @tparam T Type of the component
+ */
+template <class T>
+using ComponentPtr = typename ComponentAccess<T>::Ptr;
+
+/**
+ * @brief Get the reference to a component object, as stored in archetype tables
+ *
+ * @tparam T Type of the component
+ * @param component Component object
+ * @return ComponentRef<T> Reference to the component
+ */
+template <class T>
+inline ComponentRef<T> RefOf(T& component)
+{
+	if constexpr (IsSoA<T>)
+	{
+		return ComponentFields<T>::Bind(component);
+	}
+	else
+	{
+		return component;
+	}
+}
+
+// Helpers that apply a macro to every field name, passing the index of the field along
+#define SOA_EXPAND(x) x
+#define SOA_EACH_1(m, T, i, a) m(T, i, a)
+#define SOA_EACH_2(m, T, i, a, ...) m(T, i, a) SOA_EXPAND(SOA_EACH_1(m, T, i + 1, __VA_ARGS__))
+#define SOA_EACH_3(m, T, i, a, ...) m(T, i, a) SOA_EXPAND(SOA_EACH_2(m, T, i + 1, __VA_ARGS__))
+#define SOA_EACH_4(m, T, i, a, ...) m(T, i, a) SOA_EXPAND(SOA_EACH_3(m, T, i + 1, __VA_ARGS__))
+#define SOA_EACH_5(m, T, i, a, ...) m(T, i, a) SOA_EXPAND(SOA_EACH_4(m, T, i + 1, __VA_ARGS__))
+#define SOA_EACH_6(m, T, i, a, ...) m(T, i, a) SOA_EXPAND(SOA_EACH_5(m, T, i + 1, __VA_ARGS__))
+#define SOA_EACH_7(m, T, i, a, ...) m(T, i, a) SOA_EXPAND(SOA_EACH_6(m, T, i + 1, __VA_ARGS__))
+#define SOA_EACH_8(m, T, i, a, ...) m(T, i, a) SOA_EXPAND(SOA_EACH_7(m, T, i + 1, __VA_ARGS__))
+#define SOA_PICK(_1, _2, _3, _4, _5, _6, _7, _8, NAME, ...) NAME
+#define SOA_EACH(m, T, ...) \
+	SOA_EXPAND(SOA_PICK(__VA_ARGS__, SOA_EACH_8, SOA_EACH_7, SOA_EACH_6, SOA_EACH_5, SOA_EACH_4, SOA_EACH_3, SOA_EACH_2, SOA_EACH_1)(m, T, 0, __VA_ARGS__))
+
+#define SOA_REF_MEMBER(T, i, a) decltype(T::a)& a;
+#define SOA_REF_FIELD(T, i, a) \
+	inline decltype(T::a)& Field(FieldIndex<i>) const { return a; }
+#define SOA_STORE(T, i, a) a = value.a;
+#define SOA_LOAD(T, i, a) a,
+#define SOA_BIND(T, i, a) component.a,
+#define SOA_COUNT(T, i, a) +1
+
+/**
+ * @brief Store a component type as structure of arrays, with one array per listed field
+ *
+ * Used after the definition of the component, with the names of all of its fields in declaration order:
+ * SOA_FIELDS(Position, x, y). Supports up to eight fields.
+ *
+ */
+#define SOA_FIELDS(T, ...)                                                  \
+	template <>                                                             \
+	struct ComponentStorage<T>                                              \
+	{                                                                       \
+		static constexpr StorageType type = StorageType::SoA;               \
+	};                                                                      \
+	template <>                                                             \
+	struct ComponentFields<T>                                               \
+	{                                                                       \
+		struct Ref                                                          \
+		{                                                                   \
+			SOA_EACH(SOA_REF_MEMBER, T, __VA_ARGS__)                        \
+			SOA_EACH(SOA_REF_FIELD, T, __VA_ARGS__)                         \
+			inline const Ref& operator=(const T& value) const               \
+			{                                                               \
+				SOA_EACH(SOA_STORE, T, __VA_ARGS__)                         \
+				return *this;                                               \
+			}                                                               \
+			inline operator T() const                                       \
+			{                                                               \
+				return T { SOA_EACH(SOA_LOAD, T, __VA_ARGS__) };            \
+			}                                                               \
+		};                                                                  \
+		static constexpr std::size_t COUNT = 0 SOA_EACH(SOA_COUNT, T, __VA_ARGS__); \
+		static inline Ref Bind(T& component)                                \
+		{                                                                   \
+			return Ref { SOA_EACH(SOA_BIND, T, __VA_ARGS__) };              \
+		}                                                                   \
+	};
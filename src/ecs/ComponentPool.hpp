@@ -1,10 +1,14 @@
 #pragma once
 
 #include "ecs/Util.hpp"
+#include <vector>
 
 /**
  * @brief Pool used to store components of one type
  *
+ * The components are stored in chunks of fixed size. The pool grows by adding chunks,
+ * so pointers to components stay valid when the pool grows.
+ *
  */
 struct ComponentPool
 {
@@ -12,43 +16,136 @@ struct ComponentPool
 	 * @brief Construct a new Component Pool object
 	 *
 	 * @param elementsize Size of a component
+	 * @param chunksize Number of components per chunk, rounded up to a power of two
+	 * @param capacity Number of components that storage is reserved for
 	 */
-	ComponentPool(size_t elementsize)
+	ComponentPool(size_t elementsize, size_t chunksize, size_t capacity)
 	{
-		// The storage of the components is of fixed size, enough to hold a component for each entity
 		elementSize = elementsize;
-		components = new char[elementSize * NUM_OF_ENTITIES];
+
+		// A power of two chunk size lets the chunk and the offset be computed with a shift and a mask
+		chunkShift = 0;
+		while ((size_t(1) << chunkShift) < chunksize)
+		{
+			chunkShift++;
+		}
+		chunkMask = (size_t(1) << chunkShift) - 1;
+
+		Reserve(capacity);
 	}
 
+	/**
+	 * @brief The pool owns its chunks and can therefore not be copied
+	 *
+	 */
+	ComponentPool(const ComponentPool&) = delete;
+	ComponentPool& operator=(const ComponentPool&) = delete;
+
 	/**
 	 * @brief Destroy the Component Pool object
 	 *
 	 */
 	~ComponentPool()
 	{
-		delete[] components;
+		Release();
+	}
+
+	/**
+	 * @brief Delete the chunks that the pool owns and forget the borrowed ones
+	 *
+	 */
+	void Release()
+	{
+		for (size_t chunk = borrowed; chunk < chunks.size(); chunk++)
+		{
+			delete[] chunks[chunk];
+		}
+		chunks.clear();
+		borrowed = 0;
+	}
+
+	/**
+	 * @brief Replace the chunks of the pool with chunks in memory that the pool does not own, e.g. a mapped file
+	 *
+	 * Chunks that are added later by Reserve are owned by the pool again. The memory must outlive the pool.
+	 *
+	 * @param data First chunk, followed directly by the others
+	 * @param count Number of chunks
+	 */
+	void Borrow(char* data, size_t count)
+	{
+		Release();
+		for (size_t chunk = 0; chunk < count; chunk++)
+		{
+			chunks.push_back(data + chunk * (elementSize << chunkShift));
+		}
+		borrowed = count;
+	}
+
+	/**
+	 * @brief Make sure the pool can hold the specified number of components
+	 *
+	 * @param count Number of components
+	 */
+	void Reserve(size_t count)
+	{
+		while ((chunks.size() << chunkShift) < count)
+		{
+			chunks.push_back(new char[elementSize << chunkShift]);
+		}
+	}
+
+	/**
+	 * @brief Get the component at the specified index. The index must be below the reserved count
+	 *
+	 * @param index Index of the component
+	 * @return void* Pointer to the component
+	 */
+	inline void* get(size_t index)
+	{
+		return chunks[index >> chunkShift] + (index & chunkMask) * elementSize;
 	}
 
 	/**
- 	* @brief Get the component at the specified index
- 	*
- 	* @param index Index of the component
- 	* @return void* Pointer to the component
- 	*/
-	inline void* get()
+	 * @brief Get the component at the specified index. The index must be below the reserved count
+	 *
+	 * @tparam T Type of the components in this pool
+	 * @param index Index of the component
+	 * @return T* Pointer to the component
+	 */
+	template <typename T>
+	inline T* get(size_t index)
 	{
-		return components;
+		return reinterpret_cast<T*>(chunks[index >> chunkShift]) + (index & chunkMask);
 	}
 
 	/**
-	 * @brief Array that holds the components
+	 * @brief Chunks that hold the components
 	 *
 	 */
-	char* components { nullptr };
+	std::vector<char*> chunks;
+
+	/**
+	 * @brief Number of chunks at the front that are borrowed and not deleted by the pool
+	 *
+	 */
+	size_t borrowed { 0 };
 
 	/**
 	 * @brief Size of one component
 	 *
 	 */
 	size_t elementSize { 0 };
+
+	/**
+	 * @brief Shift that turns an index into the index of its chunk
+	 *
+	 */
+	size_t chunkShift { 0 };
+
+	/**
+	 * @brief Mask that turns an index into the offset inside its chunk
+	 *
+	 */
+	size_t chunkMask { 0 };
 };
\ No newline at end of file
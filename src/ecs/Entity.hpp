@@ -1,6 +1,6 @@
 #pragma once
 
-#include "ecs/ComponentPool.hpp"
+#include "ecs/Util.hpp"
 
 /**
  * @brief Entity that holds the information about each entity and the applied components
@@ -19,10 +19,4 @@ struct Entity
 	 *
 	 */
 	ComponentMask mask;
-
-	/**
-	 * @brief Pools for component types in this scene
-	 *
-	 */
-	std::vector<ComponentPool*> componentPools;
 };
\ No newline at end of file
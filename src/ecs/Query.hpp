@@ -0,0 +1,123 @@
+#pragma once
+
+#include "ecs/QueryBase.hpp"
+#include "ecs/Scene.hpp"
+#include "ecs/SceneView.hpp"
+#include "ecs/ThreadPool.hpp"
+#include "ecs/Util.hpp"
+
+/**
+ * @brief Cached list of the entities that have specified components
+ *
+ * Unlike a scene view, the query registers with the scene, which updates it in Assign, Remove and DestroyEntity.
+ * Iterating it therefore only costs the number of matches, no matter how many entities the scene holds.
+ * The matches are not ordered by entity index. If the scene is destroyed first, the query must not be used anymore.
+ *
+ * @tparam ComponentTypes Components that the entities should have
+ */
+template <typename... ComponentTypes>
+struct Query : QueryBase
+{
+	static_assert(sizeof...(ComponentTypes) > 0, "A query needs at least one component");
+
+	/**
+	 * @brief Construct a new Query object and collect the entities that already match
+	 *
+	 * @param scene Scene from which the entities will be gotten
+	 */
+	Query(Scene& scene) :
+		QueryBase(MaskOf<ComponentTypes...>())
+	{
+		this->scene = &scene;
+		scene.queries.push_back(this);
+		for (EntityID id : SceneView<ComponentTypes...>(scene))
+		{
+			Add(id);
+		}
+	}
+
+	/**
+	 * @brief The scene holds a pointer to the query, so it can not be copied
+	 *
+	 */
+	Query(const Query&) = delete;
+	Query& operator=(const Query&) = delete;
+
+	/**
+	 * @brief Destroy the Query object and stop the scene from updating it
+	 *
+	 */
+	~Query()
+	{
+		if (scene != nullptr)
+		{
+			scene->Unregister(this);
+		}
+	}
+
+	/**
+	 * @brief Get the iterator that starts at the first match
+	 *
+	 * @return std::vector<EntityID>::const_iterator Iterator over the IDs of the matching entities
+	 */
+	std::vector<EntityID>::const_iterator begin() const
+	{
+		return matches.begin();
+	}
+
+	/**
+	 * @brief Get the iterator that ends after the last match
+	 *
+	 * @return std::vector<EntityID>::const_iterator Iterator over the IDs of the matching entities
+	 */
+	std::vector<EntityID>::const_iterator end() const
+	{
+		return matches.end();
+	}
+
+	/**
+	 * @brief Call a function for every match with references to its components
+	 *
+	 * The matches are visited from back to front, so the function may remove components of the current entity.
+	 *
+	 * @tparam Func Type of the function
+	 * @param func Function that is called as func(EntityID, ComponentRef<ComponentTypes>...)
+	 */
+	template <typename Func>
+	void ForEach(Func func)
+	{
+		for (size_t i = matches.size(); i-- > 0;)
+		{
+			// Removing the current match moves an already visited one into its slot
+			if (i >= matches.size())
+			{
+				continue;
+			}
+			EntityID id = matches[i];
+			func(id, *scene->template GetUnchecked<ComponentTypes>(id)...);
+		}
+	}
+
+	/**
+	 * @brief Call a function for every match on all threads of a thread pool
+	 *
+	 * The matches are split into disjoint chunks, so no two threads visit the same entity. The function may write
+	 * the components of the entity it is called for, but must not add or remove components or entities.
+	 *
+	 * @tparam Func Type of the function
+	 * @param pool Thread pool that runs the chunks
+	 * @param func Function that is called as func(EntityID, ComponentRef<ComponentTypes>...)
+	 * @param grain Number of entities per chunk
+	 */
+	template <typename Func>
+	void ParallelForEach(ThreadPool& pool, Func func, size_t grain = 4096)
+	{
+		pool.ParallelFor(matches.size(), grain, [&](size_t first, size_t last) {
+			for (size_t i = first; i < last; i++)
+			{
+				EntityID id = matches[i];
+				func(id, *scene->template GetUnchecked<ComponentTypes>(id)...);
+			}
+		});
+	}
+};
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "ecs/Util.hpp"
+#include <cstdint>
+#include <vector>
+
+struct Scene;
+
+/**
+ * @brief Matching entities of a cached query, which the scene keeps up to date when component masks change
+ *
+ * The matches are packed, and every entity index maps to its slot, so adding and removing a match is O(1).
+ *
+ */
+struct QueryBase
+{
+	/**
+	 * @brief Marker for entity indexes that don't match
+	 *
+	 */
+	static constexpr std::uint32_t NONE = std::uint32_t(-1);
+
+	/**
+	 * @brief Construct a new Query Base object
+	 *
+	 * @param mask Components that the matching entities have
+	 */
+	QueryBase(const ComponentMask& mask) :
+		mask(mask)
+	{
+	}
+
+	/**
+	 * @brief Add or remove an entity after its component mask changed
+	 *
+	 * @param id ID of the entity
+	 * @param entityMask New component mask of the entity
+	 */
+	inline void Refresh(EntityID id, const ComponentMask& entityMask)
+	{
+		bool matches = (mask & entityMask) == mask;
+		if (matches != Contains(GetEntityIndex(id)))
+		{
+			matches ? Add(id) : Erase(GetEntityIndex(id));
+		}
+	}
+
+	/**
+	 * @brief Check if an entity matches
+	 *
+	 * @param index Index of the entity
+	 * @return true True if the entity matches
+	 * @return false False if the entity does not match
+	 */
+	inline bool Contains(EntityIndex index) const
+	{
+		return index < slots.size() && slots[index] != NONE;
+	}
+
+	/**
+	 * @brief Add a matching entity
+	 *
+	 * @param id ID of the entity
+	 */
+	void Add(EntityID id)
+	{
+		EntityIndex index = GetEntityIndex(id);
+		if (slots.size() <= index)
+		{
+			slots.resize(index + 1, NONE);
+		}
+		slots[index] = std::uint32_t(matches.size());
+		matches.push_back(id);
+	}
+
+	/**
+	 * @brief Remove an entity that no longer matches by moving the last match into its slot
+	 *
+	 * @param index Index of the entity
+	 */
+	void Erase(EntityIndex index)
+	{
+		std::uint32_t slot = slots[index];
+		matches[slot] = matches.back();
+		slots[GetEntityIndex(matches[slot])] = slot;
+		matches.pop_back();
+		slots[index] = NONE;
+	}
+
+	/**
+	 * @brief Get the number of matching entities
+	 *
+	 * @return size_t Number of matches
+	 */
+	inline size_t Size() const
+	{
+		return matches.size();
+	}
+
+	/**
+	 * @brief Components that the matching entities have
+	 *
+	 */
+	ComponentMask mask;
+
+	/**
+	 * @brief IDs of the matching entities
+	 *
+	 */
+	std::vector<EntityID> matches;
+
+	/**
+	 * @brief Slot of each entity index in the matches
+	 *
+	 */
+	std::vector<std::uint32_t> slots;
+
+	/**
+	 * @brief Scene that updates the query, null once the scene was destroyed
+	 *
+	 */
+	Scene* scene { nullptr };
+};
\ No newline at end of file
@@ -1,8 +1,20 @@
 #pragma once
 
+#include "Utility/MappedFile.hpp"
+#include "Utility/RadixSort.hpp"
+#include "ecs/Archetype.hpp"
+#include "ecs/Bitmap.hpp"
+#include "ecs/CommandBuffer.hpp"
 #include "ecs/ComponentPool.hpp"
 #include "ecs/Entity.hpp"
+#include "ecs/QueryBase.hpp"
+#include "ecs/SceneConfig.hpp"
+#include "ecs/SoaPool.hpp"
+#include "ecs/SparseSet.hpp"
+#include "ecs/ThreadPool.hpp"
 #include "ecs/Util.hpp"
+#include <algorithm>
+#include <bitset>
 #include <vector>
 
 /**
@@ -11,6 +23,60 @@
  */
 struct Scene
 {
+	/**
+	 * @brief Construct a new Scene object
+	 *
+	 * @param config Configuration of the scene
+	 */
+	Scene(const SceneConfig& config = SceneConfig()) :
+		config(config),
+		mode(config.mode)
+	{
+		entities.reserve(config.capacity);
+		commandBuffers.resize(1);
+	}
+
+	/**
+	 * @brief Construct a new Scene object with the default configuration and the specified storage mode
+	 *
+	 * @param mode How the components of the entities are stored
+	 */
+	Scene(StorageMode mode) :
+		Scene(SceneConfig { mode })
+	{
+	}
+
+	/**
+	 * @brief The scene owns its component pools and can therefore not be copied
+	 *
+	 */
+	Scene(const Scene&) = delete;
+	Scene& operator=(const Scene&) = delete;
+
+	/**
+	 * @brief Destroy the Scene object and all of its component pools and sparse sets
+	 *
+	 */
+	~Scene()
+	{
+		for (ComponentPool* pool : componentPools)
+		{
+			delete pool;
+		}
+		for (SparseSetBase* set : sparseSets)
+		{
+			delete set;
+		}
+		for (SoaPoolBase* pool : soaPools)
+		{
+			delete pool;
+		}
+		for (QueryBase* query : queries)
+		{
+			query->scene = nullptr;
+		}
+	}
+
 	/**
 	 * @brief Create a new entity
 	 *
@@ -22,12 +88,16 @@ struct Scene
 		{
 			EntityIndex newIndex = freeEntities.back();
 			freeEntities.pop_back();
-			Entity* entity = &entities[GetEntityIndex(newIndex)];
+			Entity* entity = &entities[newIndex];
 			EntityID newID = CreateEntityId(newIndex, GetEntityVersion(entity->id));
 			entity->id = newID;
 			return entity->id;
 		}
 		entities.push_back({ CreateEntityId(EntityIndex(entities.size()), 0), ComponentMask() });
+		if (entities.size() > membershipWords * 64)
+		{
+			GrowMembership();
+		}
 		return entities.back().id;
 	}
 
@@ -36,21 +106,66 @@ struct Scene
 	 *
 	 * @tparam T Type of component that should be retrieved
 	 * @param id ID of the entity
-	 * @return T* Pointer to the component
+	 * @return ComponentPtr<T> Pointer to the component, null if the entity does not have it
 	 */
 	template <typename T>
-	T* Get(EntityID id)
+	ComponentPtr<T> Get(EntityID id)
 	{
-		Entity* entity = &entities[GetEntityIndex(id)];
+		if (!entities[GetEntityIndex(id)].mask.test(GetId<T>()))
+		{
+			return nullptr;
+		}
+		return GetUnchecked<T>(id);
+	}
 
-		int componentId = GetId<T>();
-		if (!entity->mask.test(componentId))
+	/**
+	 * @brief Get the specified component of the specified entity, if the entity still exists
+	 *
+	 * @tparam T Type of component that should be retrieved
+	 * @param id ID of the entity, which may be outdated
+	 * @return ComponentPtr<T> Pointer to the component, null if the entity was destroyed or does not have the component
+	 */
+	template <typename T>
+	ComponentPtr<T> TryGet(EntityID id)
+	{
+		EntityIndex index = GetEntityIndex(id);
+		if (index >= entities.size() || entities[index].id != id || !entities[index].mask.test(GetId<T>()))
 		{
 			return nullptr;
 		}
+		return GetUnchecked<T>(id);
+	}
 
-		T* component = static_cast<T*>(entity->componentPools[componentId]->get());
-		return component;
+	/**
+	 * @brief Get the specified component of the specified entity without checking that the entity has it
+	 *
+	 * Meant for loops over a scene view, where the mask of the entity is already known to match.
+	 *
+	 * @tparam T Type of component that should be retrieved
+	 * @param id ID of the entity, which must have the component
+	 * @return ComponentPtr<T> Pointer to the component
+	 */
+	template <typename T>
+	ComponentPtr<T> GetUnchecked(EntityID id)
+	{
+		EntityIndex index = GetEntityIndex(id);
+		if (mode == StorageMode::Archetype)
+		{
+			return static_cast<T*>(archetypes.Get(index, GetId<T>()));
+		}
+		if constexpr (ComponentStorage<T>::type == StorageType::SparseSet)
+		{
+			return static_cast<SparseSet<T>*>(sparseSets[GetId<T>()])->Get(index);
+		}
+		else if constexpr (IsSoA<T>)
+		{
+			return static_cast<SoaPool<T>*>(soaPools[GetId<T>()])->At(index);
+		}
+		else
+		{
+			// The address is computed from the index directly, with the component size known at compile time
+			return componentPools[GetId<T>()]->template get<T>(index);
+		}
 	}
 
 	/**
@@ -58,29 +173,56 @@ struct Scene
 	 *
 	 * @tparam T Type of component that should be assigned
 	 * @param id ID of the entity
-	 * @return T* Pointer to the component
+	 * @return ComponentPtr<T> Pointer to the component
 	 */
 	template <typename T>
-	T* Assign(EntityID id)
+	ComponentPtr<T> Assign(EntityID id)
 	{
 		int componentId = GetId<T>();
 		Entity* entity = &entities[GetEntityIndex(id)];
 
-		// Add a new component pool if this type is first used
-		if (entity->componentPools.size() <= componentId)
+		ComponentPtr<T> component = nullptr;
+		if (mode == StorageMode::Archetype)
 		{
-			entity->componentPools.resize(componentId + 1, nullptr);
+			// Move the entity into the table of its new component mask
+			archetypes.Register<T>();
+			component = static_cast<T*>(archetypes.Add(id, entity->mask, componentId));
 		}
-		if (entity->componentPools[componentId] == nullptr)
+		else if constexpr (ComponentStorage<T>::type == StorageType::SparseSet)
 		{
-			entity->componentPools[componentId] = new ComponentPool(sizeof(T));
+			// Append the component to the packed arrays of its sparse set
+			component = GetSparseSet<T>()->Emplace(id);
 		}
+		else if constexpr (IsSoA<T>)
+		{
+			// Write the fields of a value initialized component into their arrays
+			SoaPool<T>* pool = GetSoaPool<T>();
+			pool->Reserve(entities.size());
+			component = pool->At(GetEntityIndex(id));
+			*component = T();
+		}
+		else
+		{
+			// Add a new component pool if this type is first used in this scene
+			if (componentPools.size() <= componentId)
+			{
+				componentPools.resize(componentId + 1, nullptr);
+			}
+			if (componentPools[componentId] == nullptr)
+			{
+				componentPools[componentId] = new ComponentPool(sizeof(T), config.chunkSize, std::max(config.capacity, entities.size()));
+			}
+			componentPools[componentId]->Reserve(entities.size());
 
-		// Looks up the component in the pool, and initializes it with placement new
-		T* component = new (entity->componentPools[componentId]->get()) T();
+			// Looks up the component in the pool, and initializes it with placement new
+			component = new (componentPools[componentId]->get(GetEntityIndex(id))) T();
+		}
 
 		// Set the bit for this component to true and return the created component
 		entity->mask.set(componentId);
+		SetMember(componentId, GetEntityIndex(id), true);
+		MarkChanged(componentId, GetEntityIndex(id));
+		RefreshQueries(id, entity->mask);
 		return component;
 	}
 
@@ -102,7 +244,64 @@ struct Scene
 		}
 
 		int componentId = GetId<T>();
+		if (mode == StorageMode::Archetype)
+		{
+			archetypes.Remove(id, entity->mask, componentId);
+		}
+		else if constexpr (ComponentStorage<T>::type == StorageType::SparseSet)
+		{
+			// Sparse sets free the slot immediately, so no stale data is left behind
+			if (entity->mask.test(componentId))
+			{
+				sparseSets[componentId]->Remove(GetEntityIndex(id));
+			}
+		}
 		entity->mask.reset(componentId);
+		SetMember(componentId, GetEntityIndex(id), false);
+		MarkChanged(componentId, GetEntityIndex(id));
+		RefreshQueries(id, entity->mask);
+	}
+
+	/**
+	 * @brief Get the sparse set of the specified component type, creating it if this type is first used
+	 *
+	 * @tparam T Type of the component. Must be stored in a sparse set
+	 * @return SparseSet<T>* Sparse set of the component type
+	 */
+	template <typename T>
+	SparseSet<T>* GetSparseSet()
+	{
+		int componentId = GetId<T>();
+		if (sparseSets.size() <= componentId)
+		{
+			sparseSets.resize(componentId + 1, nullptr);
+		}
+		if (sparseSets[componentId] == nullptr)
+		{
+			sparseSets[componentId] = new SparseSet<T>();
+		}
+		return static_cast<SparseSet<T>*>(sparseSets[componentId]);
+	}
+
+	/**
+	 * @brief Get the structure of arrays pool of the specified component type, creating it if this type is first used
+	 *
+	 * @tparam T Type of the component. Must be declared with SOA_FIELDS
+	 * @return SoaPool<T>* Pool of the component type
+	 */
+	template <typename T>
+	SoaPool<T>* GetSoaPool()
+	{
+		int componentId = GetId<T>();
+		if (soaPools.size() <= componentId)
+		{
+			soaPools.resize(componentId + 1, nullptr);
+		}
+		if (soaPools[componentId] == nullptr)
+		{
+			soaPools[componentId] = new SoaPool<T>(config.chunkSize, std::max(config.capacity, entities.size()));
+		}
+		return static_cast<SoaPool<T>*>(soaPools[componentId]);
 	}
 
 	/**
@@ -114,11 +313,292 @@ struct Scene
 	{
 		EntityID newID = CreateEntityId(EntityIndex(-1), GetEntityVersion(id) + 1);
 		Entity* entity = &entities[GetEntityIndex(id)];
+
+		// Remove the entity from its archetype table
+		if (mode == StorageMode::Archetype)
+		{
+			archetypes.RemoveEntity(GetEntityIndex(id));
+		}
+
+		// Free the components of the entity that are stored in sparse sets
+		for (int componentId = 0; componentId < sparseSets.size(); componentId++)
+		{
+			if (sparseSets[componentId] != nullptr && entity->mask.test(componentId))
+			{
+				sparseSets[componentId]->Remove(GetEntityIndex(id));
+			}
+		}
+		for (int componentId = 0; componentId < membership.size(); componentId++)
+		{
+			if (entity->mask.test(componentId))
+			{
+				SetMember(componentId, GetEntityIndex(id), false);
+				MarkChanged(componentId, GetEntityIndex(id));
+			}
+		}
+
+		for (QueryBase* query : queries)
+		{
+			if (query->Contains(GetEntityIndex(id)))
+			{
+				query->Erase(GetEntityIndex(id));
+			}
+		}
+
 		entity->id = newID;
 		entity->mask.reset();
 		freeEntities.push_back(GetEntityIndex(id));
 	}
 
+	/**
+	 * @brief Let the registered queries know that the component mask of an entity changed
+	 *
+	 * @param id ID of the entity
+	 * @param mask New component mask of the entity
+	 */
+	inline void RefreshQueries(EntityID id, const ComponentMask& mask)
+	{
+		for (QueryBase* query : queries)
+		{
+			query->Refresh(id, mask);
+		}
+	}
+
+	/**
+	 * @brief Stop updating a query
+	 *
+	 * @param query Query that is no longer updated
+	 */
+	void Unregister(QueryBase* query)
+	{
+		queries.erase(std::remove(queries.begin(), queries.end(), query), queries.end());
+	}
+
+	/**
+	 * @brief Get the membership bitmap of a component type
+	 *
+	 * @param componentId ID of the component
+	 * @return const std::uint64_t* Bitmap with one bit per entity index, null if no entity ever had the component
+	 */
+	inline const std::uint64_t* Membership(int componentId) const
+	{
+		return componentId < membership.size() && !membership[componentId].empty() ? membership[componentId].data() : nullptr;
+	}
+
+	/**
+	 * @brief Count the entities that have all of the given components, from their membership bitmaps
+	 *
+	 * @tparam ComponentTypes Types of the components
+	 * @return size_t Number of entities with all components
+	 */
+	template <typename... ComponentTypes>
+	size_t Count() const
+	{
+		const std::uint64_t* bitmaps[] = { Membership(GetId<ComponentTypes>())... };
+		for (const std::uint64_t* bitmap : bitmaps)
+		{
+			if (bitmap == nullptr)
+			{
+				return 0;
+			}
+		}
+
+		size_t count = 0;
+		for (size_t word = 0; word < (entities.size() + 63) / 64; word++)
+		{
+			count += std::bitset<64>(AndWord(bitmaps, sizeof...(ComponentTypes), word)).count();
+		}
+		return count;
+	}
+
+	/**
+	 * @brief Set or clear the bit of an entity in the membership bitmap of a component type
+	 *
+	 * @param componentId ID of the component
+	 * @param index Index of the entity
+	 * @param member Flag if the entity has the component
+	 */
+	void SetMember(int componentId, EntityIndex index, bool member)
+	{
+		if (membership.size() <= componentId)
+		{
+			membership.resize(componentId + 1);
+		}
+		std::vector<std::uint64_t>& bitmap = membership[componentId];
+		if (bitmap.empty())
+		{
+			bitmap.assign(membershipWords, 0);
+			changed.resize(membership.size());
+			changed[componentId].assign(membershipWords, 0);
+		}
+		std::uint64_t bit = std::uint64_t(1) << (index & 63);
+		bitmap[index >> 6] = member ? bitmap[index >> 6] | bit : bitmap[index >> 6] & ~bit;
+	}
+
+	/**
+	 * @brief Double the number of entities the membership bitmaps can hold, keeping them padded to whole blocks
+	 *
+	 */
+	void GrowMembership()
+	{
+		size_t words = std::max(membershipWords * 2, (config.capacity + 63) / 64);
+		membershipWords = std::max((words + BITMAP_BLOCK_WORDS - 1) / BITMAP_BLOCK_WORDS * BITMAP_BLOCK_WORDS, BITMAP_BLOCK_WORDS);
+		for (std::vector<std::uint64_t>& bitmap : membership)
+		{
+			if (!bitmap.empty())
+			{
+				bitmap.resize(membershipWords, 0);
+			}
+		}
+		for (std::vector<std::uint64_t>& bitmap : changed)
+		{
+			if (!bitmap.empty())
+			{
+				bitmap.resize(membershipWords, 0);
+			}
+		}
+	}
+
+	/**
+	 * @brief Mark the component of an entity as changed, e.g. after it was written
+	 *
+	 * Can be called from several threads at once. Nothing is marked if no entity ever had the component.
+	 *
+	 * @param componentId ID of the component
+	 * @param index Index of the entity
+	 */
+	inline void MarkChanged(int componentId, EntityIndex index)
+	{
+		MarkChangedWord(componentId, index >> 6, std::uint64_t(1) << (index & 63));
+	}
+
+	/**
+	 * @brief Mark the component of up to 64 entities as changed at once
+	 *
+	 * Can be called from several threads at once. Nothing is marked if no entity ever had the component.
+	 *
+	 * @param componentId ID of the component
+	 * @param word Index of the word in the bitmap, entity index divided by 64
+	 * @param bits Bit i is set if the component of entity word * 64 + i changed
+	 */
+	inline void MarkChangedWord(int componentId, size_t word, std::uint64_t bits)
+	{
+		if (bits != 0 && componentId < changed.size() && !changed[componentId].empty())
+		{
+			__atomic_fetch_or(&changed[componentId][word], bits, __ATOMIC_RELAXED);
+		}
+	}
+
+	/**
+	 * @brief Get the bitmap of the entities whose component changed since it was last cleared
+	 *
+	 * Components are marked when they are assigned or removed, when their entity is destroyed, and by the systems
+	 * that write them with MarkChanged.
+	 *
+	 * @param componentId ID of the component
+	 * @return const std::uint64_t* Bitmap with one bit per entity index, null if no entity ever had the component
+	 */
+	inline const std::uint64_t* Changed(int componentId) const
+	{
+		return componentId < changed.size() && !changed[componentId].empty() ? changed[componentId].data() : nullptr;
+	}
+
+	/**
+	 * @brief Clear the changes of a component type, once they were consumed
+	 *
+	 * @param componentId ID of the component
+	 */
+	void ClearChanged(int componentId)
+	{
+		if (componentId < changed.size())
+		{
+			std::fill(changed[componentId].begin(), changed[componentId].end(), 0);
+		}
+	}
+
+	/**
+	 * @brief Make sure that there is a command buffer for every thread that records commands
+	 *
+	 * @param threads Number of threads, as counted by ThreadPool::ThreadIndex
+	 */
+	void ReserveCommandBuffers(size_t threads)
+	{
+		if (commandBuffers.size() < threads)
+		{
+			commandBuffers.resize(threads);
+		}
+	}
+
+	/**
+	 * @brief Get the command buffer of the calling thread
+	 *
+	 * @return CommandBuffer& Command buffer that structural changes can be recorded into while iterating
+	 */
+	inline CommandBuffer& Commands()
+	{
+		return commandBuffers[ThreadPool::ThreadIndex()];
+	}
+
+	/**
+	 * @brief Apply the commands of all command buffers and clear them
+	 *
+	 * The commands are sorted by entity index, so the storage is walked front to back. Commands of the same entity
+	 * keep the order they were recorded in, as long as they were recorded by one thread. Commands of entities that
+	 * were destroyed in the meantime are skipped, and new entities are created last, so they can reuse the indexes
+	 * that were freed.
+	 *
+	 */
+	void Playback()
+	{
+		playback.clear();
+		for (std::uint32_t buffer = 0; buffer < commandBuffers.size(); buffer++)
+		{
+			for (CommandBuffer::Command command : commandBuffers[buffer].commands)
+			{
+				command.buffer = buffer;
+				playback.push_back(command);
+			}
+		}
+		util::radixSort(playback, playbackScratch);
+
+		for (const CommandBuffer::Command& command : playback)
+		{
+			CommandBuffer& buffer = commandBuffers[command.buffer];
+			if (command.apply == nullptr)
+			{
+				EntityID id = NewEntity();
+				if (buffer.creates[command.value])
+				{
+					buffer.creates[command.value](*this, id);
+				}
+				continue;
+			}
+
+			EntityIndex index = GetEntityIndex(command.id);
+			if (index < entities.size() && entities[index].id == command.id)
+			{
+				command.apply(*this, command.id, command.value != CommandBuffer::NO_VALUE ? &buffer.values[command.value] : nullptr);
+			}
+		}
+
+		for (CommandBuffer& buffer : commandBuffers)
+		{
+			buffer.Clear();
+		}
+	}
+
+	/**
+	 * @brief Configuration of the scene
+	 *
+	 */
+	SceneConfig config;
+
+	/**
+	 * @brief How the components of the entities are stored
+	 *
+	 */
+	StorageMode mode { StorageMode::PerComponent };
+
 	/**
 	 * @brief All entities that are contained in this scene
 	 *
@@ -130,4 +610,81 @@ struct Scene
 	 *
 	 */
 	std::vector<EntityIndex> freeEntities;
-};
\ No newline at end of file
+
+	/**
+	 * @brief One pool per component type, indexed by the component ID. Each pool holds the components of all entities
+	 *
+	 */
+	std::vector<ComponentPool*> componentPools;
+
+	/**
+	 * @brief Sparse sets of the component types that are not stored in pools, indexed by the component ID
+	 *
+	 */
+	std::vector<SparseSetBase*> sparseSets;
+
+	/**
+	 * @brief Structure of arrays pools of the component types that are declared with SOA_FIELDS, indexed by the component ID
+	 *
+	 */
+	std::vector<SoaPoolBase*> soaPools;
+
+	/**
+	 * @brief Archetype tables that hold the components if the scene uses the archetype storage mode
+	 *
+	 */
+	ArchetypeStorage archetypes;
+
+	/**
+	 * @brief One bitmap per component type, indexed by the component ID. Bit i is set if entity i has the component
+	 *
+	 */
+	std::vector<std::vector<std::uint64_t>> membership;
+
+	/**
+	 * @brief One bitmap per component type, indexed by the component ID. Bit i is set if the component of entity i changed
+	 *
+	 */
+	std::vector<std::vector<std::uint64_t>> changed;
+
+	/**
+	 * @brief Number of 64 bit words of every membership bitmap
+	 *
+	 */
+	size_t membershipWords { 0 };
+
+	/**
+	 * @brief Cached queries that are updated when component masks change. The queries are not owned by the scene
+	 *
+	 */
+	std::vector<QueryBase*> queries;
+
+	/**
+	 * @brief One command buffer per thread, indexed by ThreadPool::ThreadIndex
+	 *
+	 */
+	std::vector<CommandBuffer> commandBuffers;
+
+	/**
+	 * @brief Commands of all buffers while they are played back
+	 *
+	 */
+	std::vector<CommandBuffer::Command> playback;
+
+	/**
+	 * @brief Buffer used while sorting the commands
+	 *
+	 */
+	std::vector<CommandBuffer::Command> playbackScratch;
+
+	/**
+	 * @brief Snapshot file that the scene was loaded from. Pools of the snapshot point into it
+	 *
+	 */
+	util::MappedFile mapping;
+};
+
+inline void CommandBuffer::DestroyIn(Scene& scene, EntityID id, const void* value)
+{
+	scene.DestroyEntity(id);
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "ecs/Util.hpp"
+
+/**
+ * @brief Configuration of a scene, decided when the scene is created
+ *
+ */
+struct SceneConfig
+{
+	/**
+	 * @brief How the components of the entities are stored
+	 *
+	 */
+	StorageMode mode { StorageMode::PerComponent };
+
+	/**
+	 * @brief Number of entities that storage is reserved for up front. The scene grows beyond it when needed
+	 *
+	 */
+	size_t capacity { 500 };
+
+	/**
+	 * @brief Number of components per chunk of a component pool. Rounded up to a power of two
+	 *
+	 */
+	size_t chunkSize { 4096 };
+};
\ No newline at end of file
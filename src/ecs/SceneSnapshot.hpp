@@ -0,0 +1,744 @@
+#pragma once
+
+#include "Utility/FileSystem.hpp"
+#include "ecs/Scene.hpp"
+#include <bitset>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+/**
+ * @brief Binary snapshot of a scene, written in one sequential pass and loaded by mapping the file
+ *
+ * The file starts with a header and a table with one entry per component type, followed by the entity table, the
+ * free entity indices, and per component type its membership bitmap and its raw columns. Columns of pools are
+ * stored chunk by chunk, so loading points the pools at the mapped chunks instead of copying the components. The
+ * mapping is copy on write, so the pages are only read when they are touched and changes of the scene never reach
+ * the file. Saving writes a new file and renames it over the old one, so a scene can be saved to the file it was
+ * loaded from while its pools still point into the old one.
+ *
+ * Component types are matched by their type name, so their IDs may differ between the program that saved the
+ * snapshot and the one that loads it. The components are stored as they are in memory, so a snapshot can only be
+ * loaded by a build for the same platform, and only with the same component layouts.
+ *
+ */
+struct SceneSnapshot
+{
+	/**
+	 * @brief First bytes of every snapshot file
+	 *
+	 */
+	static constexpr char MAGIC[8] = { 'E', 'C', 'S', 'S', 'N', 'A', 'P', '\0' };
+
+	/**
+	 * @brief Version of the file format
+	 *
+	 */
+	static constexpr std::uint32_t VERSION = 1;
+
+	/**
+	 * @brief Alignment of the columns in the file, a page so that mapped chunks are aligned like allocated ones
+	 *
+	 */
+	static constexpr std::uint64_t COLUMN_ALIGNMENT = 4096;
+
+	/**
+	 * @brief Maximum number of fields of a component type, as supported by SOA_FIELDS
+	 *
+	 */
+	static constexpr std::uint32_t MAX_FIELDS = 8;
+
+	/**
+	 * @brief Largest number of components per chunk that is accepted when loading
+	 *
+	 */
+	static constexpr std::uint64_t MAX_CHUNK_SIZE = std::uint64_t(1) << 32;
+
+	/**
+	 * @brief Header at the start of the file
+	 *
+	 */
+	struct Header
+	{
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t componentCount;
+		std::uint32_t entitySize;
+		std::uint32_t padding;
+		std::uint64_t entityCount;
+		std::uint64_t freeCount;
+		std::uint64_t chunkSize;
+		std::uint64_t membershipWords;
+		std::uint64_t entitiesOffset;
+		std::uint64_t freeOffset;
+	};
+
+	/**
+	 * @brief Entry of the component type table
+	 *
+	 */
+	struct Component
+	{
+		char name[64];
+		std::uint32_t id;
+		std::uint32_t storage;
+		std::uint32_t fieldCount;
+		std::uint32_t padding;
+		std::uint64_t chunkCount;
+		std::uint64_t denseCount;
+		std::uint64_t membershipOffset;
+		std::uint64_t denseEntitiesOffset;
+		std::uint64_t fieldSizes[MAX_FIELDS];
+		std::uint64_t fieldOffsets[MAX_FIELDS];
+	};
+
+	/**
+	 * @brief Save the entities of a scene and the listed components to a file
+	 *
+	 * Component types that no entity ever had are left out. Only scenes that store their components per component
+	 * type can be saved. The snapshot is written to a temporary file next to the path, which then replaces the file
+	 * at the path. An existing file is only replaced once the new one was written completely. Windows does not
+	 * replace files that are mapped, so there saving to the file a scene was loaded from fails.
+	 *
+	 * @tparam ComponentTypes Types of the components that are saved
+	 * @param scene Scene that is saved
+	 * @param path Path of the file, which is replaced
+	 * @return true True if the snapshot was written
+	 * @return false False if the scene uses archetype storage or the file could not be written, an existing file is
+	 * left unchanged
+	 */
+	template <typename... ComponentTypes>
+	static bool Save(Scene& scene, const std::string& path)
+	{
+		if (scene.mode != StorageMode::PerComponent)
+		{
+			return false;
+		}
+
+		Header header {};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.entitySize = sizeof(Entity);
+		header.entityCount = scene.entities.size();
+		header.freeCount = scene.freeEntities.size();
+		header.chunkSize = RoundedChunkSize(scene.config.chunkSize);
+		header.membershipWords = scene.membershipWords;
+
+		SceneSnapshot snapshot;
+		snapshot.components.reserve(sizeof...(ComponentTypes));
+		snapshot.Add(scene.entities.data(), header.entityCount * sizeof(Entity), 64, &header.entitiesOffset);
+		snapshot.Add(scene.freeEntities.data(), header.freeCount * sizeof(EntityIndex), 64, &header.freeOffset);
+		(snapshot.Describe<ComponentTypes>(scene, header), ...);
+		header.componentCount = std::uint32_t(snapshot.components.size());
+
+		// Lay out the blocks behind the header and the table, then write everything front to back
+		std::uint64_t offset = sizeof(Header) + snapshot.components.size() * sizeof(Component);
+		for (Block& block : snapshot.blocks)
+		{
+			offset = (offset + block.alignment - 1) / block.alignment * block.alignment;
+			block.position = offset;
+			if (block.offset != nullptr)
+			{
+				*block.offset = offset;
+			}
+			offset += block.bytes;
+		}
+
+		// The file at the path may be mapped by the scene itself, so it must not be truncated while it is read
+		std::string temporary = path + ".tmp";
+		std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		out.write(reinterpret_cast<const char*>(snapshot.components.data()), std::streamsize(snapshot.components.size() * sizeof(Component)));
+		std::uint64_t written = sizeof(Header) + snapshot.components.size() * sizeof(Component);
+		static const char zeros[COLUMN_ALIGNMENT] = {};
+		for (const Block& block : snapshot.blocks)
+		{
+			out.write(zeros, std::streamsize(block.position - written));
+			out.write(static_cast<const char*>(block.data), std::streamsize(block.bytes));
+			written = block.position + block.bytes;
+		}
+		out.close();
+
+		std::error_code error;
+		if (!out)
+		{
+			util::fs::remove(temporary, error);
+			return false;
+		}
+		util::fs::rename(temporary, path, error);
+		if (error)
+		{
+			util::fs::remove(temporary, error);
+			return false;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Load a snapshot into an empty scene
+	 *
+	 * The entity table, the free indices and the bitmaps are copied, the columns of pools are used in place from the
+	 * mapped file, which the scene keeps open. Components in sparse sets are copied. Components of the file whose
+	 * type is not listed are skipped.
+	 *
+	 * @tparam ComponentTypes Types of the components that are loaded
+	 * @param scene Scene without entities that stores its components per component type
+	 * @param path Path of the file
+	 * @return true True if the snapshot was loaded
+	 * @return false False if the scene is not empty or the file is not a valid snapshot, the scene is left unchanged
+	 */
+	template <typename... ComponentTypes>
+	static bool Load(Scene& scene, const std::string& path)
+	{
+		if (scene.mode != StorageMode::PerComponent || !scene.entities.empty())
+		{
+			return false;
+		}
+
+		util::MappedFile file;
+		if (!file.open(path) || file.size() < sizeof(Header))
+		{
+			return false;
+		}
+		const Header& header = *reinterpret_cast<const Header*>(file.data());
+		// Entity indices are 32 bits, the last one marks invalid entities
+		std::vector<std::uint64_t> alive;
+		if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION || header.entitySize != sizeof(Entity)
+			|| header.entityCount >= std::numeric_limits<EntityIndex>::max() || header.chunkSize == 0 || header.chunkSize > MAX_CHUNK_SIZE
+			|| (header.chunkSize & (header.chunkSize - 1)) != 0 || header.membershipWords < (header.entityCount + 63) / 64
+			|| !Fits(file, sizeof(Header), header.componentCount, sizeof(Component))
+			|| !Fits(file, header.entitiesOffset, header.entityCount, sizeof(Entity))
+			|| !Fits(file, header.freeOffset, header.freeCount, sizeof(EntityIndex))
+			|| !ValidEntities(file, header, alive))
+		{
+			return false;
+		}
+		const Component* table = reinterpret_cast<const Component*>(file.data() + sizeof(Header));
+		for (std::uint32_t i = 0; i < header.componentCount; i++)
+		{
+			if (!Valid(file, header, table[i], alive))
+			{
+				return false;
+			}
+		}
+
+		// Match the listed types with the table before anything of the scene is changed
+		int matches[] = { Find<ComponentTypes>(table, header.componentCount)... };
+		size_t loaded = 0;
+		for (int match : matches)
+		{
+			if (match == MISMATCH)
+			{
+				return false;
+			}
+			loaded += match != NOT_FOUND;
+		}
+
+		scene.config.chunkSize = header.chunkSize;
+		const Entity* entities = reinterpret_cast<const Entity*>(file.data() + header.entitiesOffset);
+		const EntityIndex* freeEntities = reinterpret_cast<const EntityIndex*>(file.data() + header.freeOffset);
+		scene.entities.assign(entities, entities + header.entityCount);
+		scene.freeEntities.assign(freeEntities, freeEntities + header.freeCount);
+		scene.membershipWords = header.membershipWords;
+		for (std::vector<std::uint64_t>& bitmap : scene.membership)
+		{
+			bitmap.clear();
+		}
+		for (std::vector<std::uint64_t>& bitmap : scene.changed)
+		{
+			bitmap.clear();
+		}
+
+		size_t match = 0;
+		bool sameIds = true;
+		((Restore<ComponentTypes>(scene, file, matches[match] >= 0 ? &table[matches[match]] : nullptr, sameIds), match++), ...);
+
+		// The masks of the file hold the component IDs of the program that saved it, and the skipped types
+		if (!sameIds || loaded != header.componentCount)
+		{
+			for (Entity& entity : scene.entities)
+			{
+				entity.mask.reset();
+			}
+			(RestoreMask<ComponentTypes>(scene), ...);
+		}
+
+		// Queries that were registered with the empty scene learn about the loaded entities
+		if (!scene.queries.empty())
+		{
+			for (const Entity& entity : scene.entities)
+			{
+				if (IsEntityValid(entity.id))
+				{
+					scene.RefreshQueries(entity.id, entity.mask);
+				}
+			}
+		}
+
+		std::swap(scene.mapping.bytes, file.bytes);
+		std::swap(scene.mapping.length, file.length);
+		return true;
+	}
+
+	/**
+	 * @brief Bytes that are written to the file after the header and the table
+	 *
+	 */
+	struct Block
+	{
+		/**
+		 * @brief Bytes in memory
+		 *
+		 */
+		const void* data;
+
+		/**
+		 * @brief Number of bytes
+		 *
+		 */
+		std::uint64_t bytes;
+
+		/**
+		 * @brief Alignment of the block in the file
+		 *
+		 */
+		std::uint64_t alignment;
+
+		/**
+		 * @brief Where the offset of the block in the file is stored, in the header or the table. Null if it is
+		 * not looked up when loading
+		 *
+		 */
+		std::uint64_t* offset;
+
+		/**
+		 * @brief Offset of the block in the file
+		 *
+		 */
+		std::uint64_t position;
+	};
+
+	/**
+	 * @brief Add a block to the blocks that are written
+	 *
+	 * @param data Bytes in memory
+	 * @param bytes Number of bytes
+	 * @param alignment Alignment of the block in the file
+	 * @param offset Where the offset of the block in the file is stored, can be null
+	 */
+	void Add(const void* data, std::uint64_t bytes, std::uint64_t alignment, std::uint64_t* offset)
+	{
+		blocks.push_back({ data, bytes, alignment, offset, 0 });
+	}
+
+	/**
+	 * @brief Add the table entry of a component type and the blocks of its bitmap and columns
+	 *
+	 * @tparam T Type of the component
+	 * @param scene Scene that is saved
+	 * @param header Header of the file
+	 */
+	template <typename T>
+	void Describe(Scene& scene, const Header& header)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Components are saved as raw bytes");
+		int componentId = GetId<T>();
+		const std::uint64_t* membership = scene.Membership(componentId);
+		if (membership == nullptr)
+		{
+			return;
+		}
+
+		ComponentPool* pool = nullptr;
+		if constexpr (ComponentStorage<T>::type == StorageType::Pool)
+		{
+			pool = componentId < scene.componentPools.size() ? scene.componentPools[componentId] : nullptr;
+			if (pool == nullptr)
+			{
+				return;
+			}
+		}
+
+		Component component {};
+		std::strncpy(component.name, typeid(T).name(), sizeof(component.name) - 1);
+		component.id = std::uint32_t(componentId);
+		component.storage = std::uint32_t(ComponentStorage<T>::type);
+		components.push_back(component);
+		Component& entry = components.back();
+		Add(membership, header.membershipWords * sizeof(std::uint64_t), 64, &entry.membershipOffset);
+
+		// Only chunks that can hold saved entities are written
+		size_t chunkCount = (header.entityCount + header.chunkSize - 1) / header.chunkSize;
+		if constexpr (ComponentStorage<T>::type == StorageType::SparseSet)
+		{
+			SparseSet<T>* set = scene.GetSparseSet<T>();
+			entry.fieldCount = 1;
+			entry.denseCount = set->Size();
+			entry.fieldSizes[0] = sizeof(T);
+			Add(set->dense.data(), entry.denseCount * sizeof(T), 64, &entry.fieldOffsets[0]);
+			Add(set->denseEntities.data(), entry.denseCount * sizeof(EntityID), 64, &entry.denseEntitiesOffset);
+		}
+		else if constexpr (IsSoA<T>)
+		{
+			DescribeFields(entry, scene.GetSoaPool<T>()->fields, chunkCount);
+		}
+		else
+		{
+			DescribeFields(entry, { pool }, chunkCount);
+		}
+	}
+
+	/**
+	 * @brief Add the columns of the fields of a pool, chunk by chunk
+	 *
+	 * @param entry Table entry of the component type
+	 * @param fields Pool of every field
+	 * @param chunkCount Number of chunks that are written per field
+	 */
+	void DescribeFields(Component& entry, const std::vector<ComponentPool*>& fields, size_t chunkCount)
+	{
+		entry.fieldCount = std::uint32_t(fields.size());
+		entry.chunkCount = std::min(chunkCount, fields[0]->chunks.size());
+		for (size_t field = 0; field < fields.size(); field++)
+		{
+			std::uint64_t chunkBytes = fields[field]->elementSize << fields[field]->chunkShift;
+			entry.fieldSizes[field] = fields[field]->elementSize;
+			for (size_t chunk = 0; chunk < entry.chunkCount; chunk++)
+			{
+				// The chunks of a column follow each other directly, so only the first one stores its offset
+				Add(fields[field]->chunks[chunk], chunkBytes, chunk == 0 ? COLUMN_ALIGNMENT : 1, chunk == 0 ? &entry.fieldOffsets[field] : nullptr);
+			}
+		}
+	}
+
+	/**
+	 * @brief Find the table entry of a component type
+	 *
+	 * @tparam T Type of the component
+	 * @param table Component type table of the file
+	 * @param count Number of entries
+	 * @return int Index of the entry, NOT_FOUND if no entity had the component, or MISMATCH if the entry does not
+	 * match the layout of the type
+	 */
+	template <typename T>
+	static int Find(const Component* table, std::uint32_t count)
+	{
+		char name[sizeof(Component::name)] = {};
+		std::strncpy(name, typeid(T).name(), sizeof(name) - 1);
+		for (std::uint32_t i = 0; i < count; i++)
+		{
+			if (std::strncmp(table[i].name, name, sizeof(name)) != 0)
+			{
+				continue;
+			}
+			std::vector<std::uint64_t> sizes = FieldSizes<T>();
+			if (table[i].storage != std::uint32_t(ComponentStorage<T>::type) || table[i].fieldCount != sizes.size() || !std::equal(sizes.begin(), sizes.end(), table[i].fieldSizes))
+			{
+				return MISMATCH;
+			}
+			return int(i);
+		}
+		return NOT_FOUND;
+	}
+
+	/**
+	 * @brief Restore the bitmap and the storage of a component type from the mapped file
+	 *
+	 * @tparam T Type of the component
+	 * @param scene Scene that is loaded
+	 * @param file Mapped snapshot file
+	 * @param entry Table entry of the type, null if no entity had the component
+	 * @param sameIds Cleared if the type had another ID in the program that saved the file
+	 */
+	template <typename T>
+	static void Restore(Scene& scene, util::MappedFile& file, const Component* entry, bool& sameIds)
+	{
+		if (entry == nullptr)
+		{
+			return;
+		}
+		int componentId = GetId<T>();
+		sameIds = sameIds && entry->id == std::uint32_t(componentId);
+
+		const std::uint64_t* membership = reinterpret_cast<const std::uint64_t*>(file.data() + entry->membershipOffset);
+		if (scene.membership.size() <= componentId)
+		{
+			scene.membership.resize(componentId + 1);
+			scene.changed.resize(componentId + 1);
+		}
+		scene.membership[componentId].assign(membership, membership + scene.membershipWords);
+		scene.changed[componentId].assign(scene.membershipWords, 0);
+
+		if constexpr (ComponentStorage<T>::type == StorageType::SparseSet)
+		{
+			SparseSet<T>* set = scene.GetSparseSet<T>();
+			const T* dense = reinterpret_cast<const T*>(file.data() + entry->fieldOffsets[0]);
+			const EntityID* denseEntities = reinterpret_cast<const EntityID*>(file.data() + entry->denseEntitiesOffset);
+			set->dense.assign(dense, dense + entry->denseCount);
+			set->denseEntities.assign(denseEntities, denseEntities + entry->denseCount);
+			set->sparse.assign(scene.entities.size(), SparseSetBase::INVALID_SLOT);
+			for (size_t slot = 0; slot < entry->denseCount; slot++)
+			{
+				set->sparse[GetEntityIndex(denseEntities[slot])] = EntityIndex(slot);
+			}
+		}
+		else if constexpr (IsSoA<T>)
+		{
+			SoaPool<T>* pool = new SoaPool<T>(scene.config.chunkSize, 0);
+			for (size_t field = 0; field < pool->fields.size(); field++)
+			{
+				pool->fields[field]->Borrow(file.data() + entry->fieldOffsets[field], entry->chunkCount);
+			}
+			if (scene.soaPools.size() <= componentId)
+			{
+				scene.soaPools.resize(componentId + 1, nullptr);
+			}
+			delete scene.soaPools[componentId];
+			scene.soaPools[componentId] = pool;
+		}
+		else
+		{
+			ComponentPool* pool = new ComponentPool(sizeof(T), scene.config.chunkSize, 0);
+			pool->Borrow(file.data() + entry->fieldOffsets[0], entry->chunkCount);
+			if (scene.componentPools.size() <= componentId)
+			{
+				scene.componentPools.resize(componentId + 1, nullptr);
+			}
+			delete scene.componentPools[componentId];
+			scene.componentPools[componentId] = pool;
+		}
+	}
+
+	/**
+	 * @brief Set the bit of a component type in the masks of the entities that have it, from its bitmap
+	 *
+	 * @tparam T Type of the component
+	 * @param scene Scene that is loaded
+	 */
+	template <typename T>
+	static void RestoreMask(Scene& scene)
+	{
+		int componentId = GetId<T>();
+		const std::uint64_t* membership = scene.Membership(componentId);
+		for (size_t word = 0; membership != nullptr && word < (scene.entities.size() + 63) / 64; word++)
+		{
+			for (std::uint64_t bits = membership[word]; bits != 0; bits &= bits - 1)
+			{
+				scene.entities[word * 64 + LowestBit(bits)].mask.set(componentId);
+			}
+		}
+	}
+
+	/**
+	 * @brief Check the entity table and the free entity indices, which the scene indexes with without further checks
+	 *
+	 * Every entity has to be destroyed or sit at its own index, and every free index has to belong to a destroyed
+	 * entity, at most once.
+	 *
+	 * @param file Mapped snapshot file
+	 * @param header Header of the file, whose ranges were checked to lie inside the file
+	 * @param alive Bitmap of the entities that are not destroyed, filled for the checks of the table entries
+	 * @return true True if the entities can be restored
+	 * @return false False if an entity or a free index is out of range
+	 */
+	static bool ValidEntities(const util::MappedFile& file, const Header& header, std::vector<std::uint64_t>& alive)
+	{
+		const Entity* entities = reinterpret_cast<const Entity*>(file.data() + header.entitiesOffset);
+		alive.assign((header.entityCount + 63) / 64, 0);
+		for (std::uint64_t index = 0; index < header.entityCount; index++)
+		{
+			if (IsEntityValid(entities[index].id))
+			{
+				if (GetEntityIndex(entities[index].id) != index)
+				{
+					return false;
+				}
+				alive[index >> 6] |= std::uint64_t(1) << (index & 63);
+			}
+		}
+
+		std::vector<bool> freed(header.entityCount, false);
+		const EntityIndex* freeEntities = reinterpret_cast<const EntityIndex*>(file.data() + header.freeOffset);
+		for (std::uint64_t i = 0; i < header.freeCount; i++)
+		{
+			EntityIndex index = freeEntities[i];
+			if (index >= header.entityCount || freed[index] || ((alive[index >> 6] >> (index & 63)) & 1))
+			{
+				return false;
+			}
+			freed[index] = true;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Check that the bitmap and the columns of a table entry lie inside the file and match each other
+	 *
+	 * Only entities that are not destroyed may have the component. Pools must hold a chunk for each of them, and
+	 * sparse sets exactly one component for each of them.
+	 *
+	 * @param file Mapped snapshot file
+	 * @param header Header of the file
+	 * @param entry Table entry
+	 * @param alive Bitmap of the entities that are not destroyed
+	 * @return true True if the entry can be restored
+	 * @return false False if the entry points outside of the file or does not match its bitmap
+	 */
+	static bool Valid(const util::MappedFile& file, const Header& header, const Component& entry, const std::vector<std::uint64_t>& alive)
+	{
+		if (entry.fieldCount == 0 || entry.fieldCount > MAX_FIELDS || entry.chunkCount > (header.entityCount + header.chunkSize - 1) / header.chunkSize
+			|| !Fits(file, entry.membershipOffset, header.membershipWords, sizeof(std::uint64_t)))
+		{
+			return false;
+		}
+
+		const std::uint64_t* membership = reinterpret_cast<const std::uint64_t*>(file.data() + entry.membershipOffset);
+		std::uint64_t members = 0;
+		std::uint64_t stored = entry.storage == std::uint32_t(StorageType::SparseSet) ? header.entityCount : entry.chunkCount * header.chunkSize;
+		for (std::uint64_t word = 0; word < header.membershipWords; word++)
+		{
+			std::uint64_t allowed = word < alive.size() ? alive[word] & StoredBits(word, stored) : 0;
+			if ((membership[word] & ~allowed) != 0)
+			{
+				return false;
+			}
+			members += std::bitset<64>(membership[word]).count();
+		}
+
+		if (entry.storage == std::uint32_t(StorageType::SparseSet))
+		{
+			if (entry.denseCount != members || !Fits(file, entry.fieldOffsets[0], entry.denseCount, entry.fieldSizes[0])
+				|| !Fits(file, entry.denseEntitiesOffset, entry.denseCount, sizeof(EntityID)))
+			{
+				return false;
+			}
+
+			// Every member owns exactly one component, clearing its bit finds entities that are listed twice
+			std::vector<std::uint64_t> unseen(membership, membership + header.membershipWords);
+			const EntityID* denseEntities = reinterpret_cast<const EntityID*>(file.data() + entry.denseEntitiesOffset);
+			for (std::uint64_t slot = 0; slot < entry.denseCount; slot++)
+			{
+				std::uint64_t index = GetEntityIndex(denseEntities[slot]);
+				if (index >= header.entityCount || ((unseen[index >> 6] >> (index & 63)) & 1) == 0)
+				{
+					return false;
+				}
+				unseen[index >> 6] &= ~(std::uint64_t(1) << (index & 63));
+			}
+			return true;
+		}
+
+		for (std::uint32_t field = 0; field < entry.fieldCount; field++)
+		{
+			if (entry.fieldOffsets[field] % COLUMN_ALIGNMENT != 0 || !Fits(file, entry.fieldOffsets[field], entry.chunkCount * header.chunkSize, entry.fieldSizes[field]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Check that an array lies inside the file, without overflowing while computing its size
+	 *
+	 * @param file Mapped snapshot file
+	 * @param offset Offset of the first byte
+	 * @param count Number of elements
+	 * @param size Size of one element
+	 * @return true True if the array lies inside the file
+	 * @return false False if the array ends after the file
+	 */
+	static bool Fits(const util::MappedFile& file, std::uint64_t offset, std::uint64_t count, std::uint64_t size)
+	{
+		return offset <= file.size() && (size == 0 || count <= (file.size() - offset) / size);
+	}
+
+	/**
+	 * @brief Get the bits of a bitmap word whose entities have room in the stored columns
+	 *
+	 * @param word Index of the word
+	 * @param stored Number of entities the columns hold
+	 * @return std::uint64_t Mask of the bits below stored
+	 */
+	static std::uint64_t StoredBits(std::uint64_t word, std::uint64_t stored)
+	{
+		if (stored <= word * 64)
+		{
+			return 0;
+		}
+		std::uint64_t bits = stored - word * 64;
+		return bits >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1;
+	}
+
+	/**
+	 * @brief Get the number of components per chunk that the pools use for a configured chunk size
+	 *
+	 * @param chunkSize Configured chunk size
+	 * @return std::uint64_t Chunk size rounded up to a power of two
+	 */
+	static std::uint64_t RoundedChunkSize(size_t chunkSize)
+	{
+		std::uint64_t rounded = 1;
+		while (rounded < chunkSize)
+		{
+			rounded <<= 1;
+		}
+		return rounded;
+	}
+
+	/**
+	 * @brief Get the sizes of the fields of a component type, as they are stored in its pool
+	 *
+	 * @tparam T Type of the component
+	 * @return const std::vector<std::uint64_t>& Size of every field, the size of the component if it is not split
+	 */
+	template <typename T>
+	static std::vector<std::uint64_t> FieldSizes()
+	{
+		if constexpr (IsSoA<T>)
+		{
+			return FieldSizes<T>(std::make_index_sequence<ComponentFields<T>::COUNT>());
+		}
+		else
+		{
+			return { sizeof(T) };
+		}
+	}
+
+	/**
+	 * @brief Get the sizes of the fields of a structure of arrays component type, one field per index
+	 *
+	 */
+	template <typename T, size_t... I>
+	static std::vector<std::uint64_t> FieldSizes(std::index_sequence<I...>)
+	{
+		return { sizeof(typename SoaPool<T>::template FieldType<I>)... };
+	}
+
+	/**
+	 * @brief Result of Find if no entity had the component when the snapshot was saved
+	 *
+	 */
+	static constexpr int NOT_FOUND = -1;
+
+	/**
+	 * @brief Result of Find if the component was saved with another layout
+	 *
+	 */
+	static constexpr int MISMATCH = -2;
+
+	/**
+	 * @brief Table entries of the saved component types
+	 *
+	 */
+	std::vector<Component> components;
+
+	/**
+	 * @brief Blocks in the order they are written
+	 *
+	 */
+	std::vector<Block> blocks;
+};
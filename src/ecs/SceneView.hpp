@@ -1,10 +1,20 @@
 #pragma once
 
+#include "ecs/Bitmap.hpp"
+#include "ecs/Scene.hpp"
+#include "ecs/ThreadPool.hpp"
 #include "ecs/Util.hpp"
+#include <array>
 
 /**
  * @brief Scene view used to iterate over entities that have specified components from a scene
  *
+ * If one of the components is stored in a sparse set, only the entities of the smallest such set are visited.
+ * These are iterated from back to front, so removing the component of the current entity is safe.
+ * If the scene uses archetype storage, only the tables whose mask matches are visited, also from back to front.
+ * Otherwise the membership bitmaps of the components are intersected, so entities without all of them are skipped
+ * without being loaded. Entities must not be created while the view is iterated.
+ *
  * @tparam ComponentTypes Components that the entities should have
  */
 template <typename... ComponentTypes>
@@ -70,12 +80,16 @@ struct SceneView
 		 * @param index Start index for iteration
 		 * @param mask Mask that determines which components the entities need to have
 		 * @param all Flag if all entities should be iterated, no matter which components they have
+		 * @param dense Owning entities of a sparse set that is iterated instead of all entities, can be null
+		 * @param start Lowest entity index that is visited when iterating a sparse set
 		 */
-		Iterator(Scene* scene, EntityIndex index, ComponentMask mask, bool all) :
+		Iterator(Scene* scene, EntityIndex index, ComponentMask mask, bool all, const std::vector<EntityID>* dense = nullptr, EntityIndex start = 0) :
 			scene(scene),
 			index(index),
 			mask(mask),
-			all(all)
+			all(all),
+			dense(dense),
+			start(start)
 		{}
 
 		/**
@@ -85,6 +99,14 @@ struct SceneView
 		 */
 		EntityID operator*() const
 		{
+			if (tables)
+			{
+				return scene->archetypes.archetypes[archetype]->EntityAt(index - 1);
+			}
+			if (dense != nullptr)
+			{
+				return (*dense)[index - 1];
+			}
 			return scene->entities[index].id;
 		}
 
@@ -97,6 +119,14 @@ struct SceneView
 		 */
 		bool operator==(const Iterator& other) const
 		{
+			if (tables)
+			{
+				return archetype >= scene->archetypes.archetypes.size();
+			}
+			if (dense != nullptr)
+			{
+				return index == 0;
+			}
 			return index == other.index || index == scene->entities.size();
 		}
 
@@ -109,6 +139,14 @@ struct SceneView
 		 */
 		bool operator!=(const Iterator& other) const
 		{
+			if (tables)
+			{
+				return archetype < scene->archetypes.archetypes.size();
+			}
+			if (dense != nullptr)
+			{
+				return index != 0;
+			}
 			return index != other.index && index != scene->entities.size();
 		}
 
@@ -120,6 +158,22 @@ struct SceneView
 		 */
 		bool ValidIndex()
 		{
+			if (tables)
+			{
+				// The mask of the whole table was already checked
+				return GetEntityIndex(**this) >= start;
+			}
+			if (bits)
+			{
+				// The bitmaps only hold entities that exist and have the component
+				return true;
+			}
+			if (dense != nullptr)
+			{
+				// Entities of a sparse set are always valid, but may lack the other components
+				EntityIndex entityIndex = GetEntityIndex((*dense)[index - 1]);
+				return entityIndex >= start && mask == (mask & scene->entities[entityIndex].mask);
+			}
 			return
 				// It's a valid entity ID
 				IsEntityValid(scene->entities[index].id) &&
@@ -134,6 +188,34 @@ struct SceneView
 		 */
 		Iterator& operator++()
 		{
+			if (tables)
+			{
+				// Step towards the front of the table, then continue with the next matching table
+				do
+				{
+					index = EntityIndex(std::min<size_t>(index - 1, scene->archetypes.archetypes[archetype]->count));
+					if (index == 0)
+					{
+						NextArchetype(archetype + 1);
+					}
+				} while (archetype < scene->archetypes.archetypes.size() && !ValidIndex());
+				return *this;
+			}
+			if (dense != nullptr)
+			{
+				// Step towards the front. Removing the current entity moves an already visited one into its slot
+				do
+				{
+					index = EntityIndex(std::min<size_t>(index - 1, dense->size()));
+				} while (index > 0 && !ValidIndex());
+				return *this;
+			}
+			if (bits)
+			{
+				// Jump to the next entity that has all components
+				index = EntityIndex(NextSetBit(bitmaps, bitmapCount, size_t(index) + 1, scene->entities.size()));
+				return *this;
+			}
 			do
 			{
 				index++;
@@ -141,6 +223,24 @@ struct SceneView
 			return *this;
 		}
 
+		/**
+		 * @brief Move to the last row of the first non-empty table with a matching mask
+		 *
+		 * @param from Index of the first table that is checked
+		 */
+		void NextArchetype(size_t from)
+		{
+			const std::vector<Archetype*>& archetypes = scene->archetypes.archetypes;
+			for (archetype = from; archetype < archetypes.size(); archetype++)
+			{
+				if (archetypes[archetype]->count > 0 && mask == (mask & archetypes[archetype]->mask))
+				{
+					index = EntityIndex(archetypes[archetype]->count);
+					return;
+				}
+			}
+		}
+
 		/**
 		 * @brief Index of the current iterated entity
 		 *
@@ -164,6 +264,48 @@ struct SceneView
 		 *
 		 */
 		bool all { false };
+
+		/**
+		 * @brief Owning entities of the iterated sparse set, null if all entities are iterated
+		 *
+		 */
+		const std::vector<EntityID>* dense { nullptr };
+
+		/**
+		 * @brief Lowest entity index that is visited when iterating a sparse set
+		 *
+		 */
+		EntityIndex start { 0 };
+
+		/**
+		 * @brief Flag if archetype tables are iterated instead of all entities
+		 *
+		 */
+		bool tables { false };
+
+		/**
+		 * @brief Index of the iterated archetype table
+		 *
+		 */
+		size_t archetype { 0 };
+
+		/**
+		 * @brief Flag if the membership bitmaps are intersected instead of checking every entity
+		 *
+		 */
+		bool bits { false };
+
+		/**
+		 * @brief Membership bitmaps of the requested components
+		 *
+		 */
+		const std::uint64_t* const* bitmaps { nullptr };
+
+		/**
+		 * @brief Number of membership bitmaps
+		 *
+		 */
+		size_t bitmapCount { 0 };
 	};
 
 	/**
@@ -173,6 +315,41 @@ struct SceneView
 	 */
 	const Iterator begin() const
 	{
+		// Iterate the matching archetype tables instead of all entities
+		if (scene->mode == StorageMode::Archetype && !all)
+		{
+			Iterator it(scene, 0, componentMask, all, nullptr, start);
+			it.tables = true;
+			it.NextArchetype(0);
+			if (it.archetype < scene->archetypes.archetypes.size() && !it.ValidIndex())
+			{
+				++it;
+			}
+			return it;
+		}
+
+		// Iterate the smallest sparse set of the requested components instead of all entities, if there is one
+		const std::vector<EntityID>* dense = SmallestSparseSet();
+		if (dense != nullptr)
+		{
+			Iterator it(scene, EntityIndex(dense->size()) + 1, componentMask, all, dense, start);
+			return ++it;
+		}
+
+		// Intersect the membership bitmaps of the requested components
+		if (!all)
+		{
+			if (!FetchBitmaps())
+			{
+				return end();
+			}
+			Iterator it(scene, EntityIndex(NextSetBit(bitmaps.data(), sizeof...(ComponentTypes), start, scene->entities.size())), componentMask, all);
+			it.bits = true;
+			it.bitmaps = bitmaps.data();
+			it.bitmapCount = sizeof...(ComponentTypes);
+			return it;
+		}
+
 		int firstIndex = start;
 		while (firstIndex < scene->entities.size() && (componentMask != (componentMask & scene->entities[firstIndex].mask) || !IsEntityValid(scene->entities[firstIndex].id)))
 		{
@@ -191,6 +368,227 @@ struct SceneView
 		return Iterator(scene, EntityIndex(scene->entities.size()), componentMask, all);
 	}
 
+	/**
+	 * @brief Call a function for every entity of this view with references to its components
+	 *
+	 * In archetype storage the columns of every matching table are walked directly, without looking up each entity.
+	 * The function must not add or remove components or entities.
+	 *
+	 * @tparam Func Type of the function
+	 * @param func Function that is called as func(EntityID, ComponentRef<ComponentTypes>...)
+	 */
+	template <typename Func>
+	void ForEach(Func func) const
+	{
+		if (scene->mode != StorageMode::Archetype || all)
+		{
+			for (EntityID id : *this)
+			{
+				func(id, *scene->template GetUnchecked<ComponentTypes>(id)...);
+			}
+			return;
+		}
+
+		for (Archetype* archetype : scene->archetypes.archetypes)
+		{
+			if (componentMask != (componentMask & archetype->mask))
+			{
+				continue;
+			}
+			for (size_t chunk = 0; chunk < archetype->ChunkCount(); chunk++)
+			{
+				size_t rows = archetype->RowsInChunk(chunk);
+				const EntityID* ids = archetype->Entities(chunk);
+				auto forEachRow = [&](ComponentTypes*... columns) {
+					for (size_t row = 0; row < rows; row++)
+					{
+						if (GetEntityIndex(ids[row]) >= start)
+						{
+							func(ids[row], RefOf(columns[row])...);
+						}
+					}
+				};
+				forEachRow(reinterpret_cast<ComponentTypes*>(archetype->Column(chunk, archetype->columnOf[GetId<ComponentTypes>()]))...);
+			}
+		}
+	}
+
+	/**
+	 * @brief Call a function for every entity of this view on all threads of a thread pool
+	 *
+	 * The entities are split into disjoint chunks of about grain entities, so no two threads visit the same entity.
+	 * The function may write the components of the entity it is called for, but must not add or remove components
+	 * or entities, and must not touch other entities.
+	 *
+	 * @tparam Func Type of the function
+	 * @param pool Thread pool that runs the chunks
+	 * @param func Function that is called as func(EntityID, ComponentRef<ComponentTypes>...)
+	 * @param grain Number of entities per chunk
+	 */
+	template <typename Func>
+	void ParallelForEach(ThreadPool& pool, Func func, size_t grain = 4096) const
+	{
+		if (scene->mode == StorageMode::Archetype && !all)
+		{
+			// Split the chunks of the matching tables into ranges of rows
+			struct Rows
+			{
+				Archetype* archetype;
+				size_t chunk;
+				size_t first;
+				size_t last;
+			};
+			std::vector<Rows> ranges;
+			for (Archetype* archetype : scene->archetypes.archetypes)
+			{
+				if (componentMask != (componentMask & archetype->mask))
+				{
+					continue;
+				}
+				for (size_t chunk = 0; chunk < archetype->ChunkCount(); chunk++)
+				{
+					size_t rows = archetype->RowsInChunk(chunk);
+					for (size_t first = 0; first < rows; first += grain)
+					{
+						ranges.push_back({ archetype, chunk, first, std::min(rows, first + grain) });
+					}
+				}
+			}
+
+			// Small ranges of the same chunk are handed out together
+			pool.ParallelFor(ranges.size(), std::max<size_t>(grain / ARCHETYPE_CHUNK_ROWS, 1), [&](size_t first, size_t last) {
+				for (size_t range = first; range < last; range++)
+				{
+					const Rows& rows = ranges[range];
+					const EntityID* ids = rows.archetype->Entities(rows.chunk);
+					auto forEachRow = [&](ComponentTypes*... columns) {
+						for (size_t row = rows.first; row < rows.last; row++)
+						{
+							if (GetEntityIndex(ids[row]) >= start)
+							{
+								func(ids[row], RefOf(columns[row])...);
+							}
+						}
+					};
+					forEachRow(reinterpret_cast<ComponentTypes*>(rows.archetype->Column(rows.chunk, rows.archetype->columnOf[GetId<ComponentTypes>()]))...);
+				}
+			});
+			return;
+		}
+
+		// Split the smallest sparse set of the requested components, if there is one
+		const std::vector<EntityID>* dense = SmallestSparseSet();
+		if (dense != nullptr)
+		{
+			pool.ParallelFor(dense->size(), grain, [&](size_t first, size_t last) {
+				for (size_t i = first; i < last; i++)
+				{
+					EntityID id = (*dense)[i];
+					EntityIndex index = GetEntityIndex(id);
+					if (index >= start && componentMask == (componentMask & scene->entities[index].mask))
+					{
+						func(id, *scene->template GetUnchecked<ComponentTypes>(id)...);
+					}
+				}
+			});
+			return;
+		}
+
+		// Otherwise split the entity indexes. Chunks cover whole words of the membership bitmaps
+		size_t count = scene->entities.size() > start ? scene->entities.size() - start : 0;
+		if (!all)
+		{
+			if (!FetchBitmaps())
+			{
+				return;
+			}
+			size_t end = scene->entities.size();
+			pool.ParallelFor((end + 63) / 64, std::max<size_t>(grain / 64, 1), [&](size_t first, size_t last) {
+				size_t to = std::min(last * 64, end);
+				for (size_t i = NextSetBit(bitmaps.data(), sizeof...(ComponentTypes), std::max<size_t>(first * 64, start), to); i < to; i = NextSetBit(bitmaps.data(), sizeof...(ComponentTypes), i + 1, to))
+				{
+					EntityID id = scene->entities[i].id;
+					func(id, *scene->template GetUnchecked<ComponentTypes>(id)...);
+				}
+			});
+			return;
+		}
+		pool.ParallelFor(count, grain, [&](size_t first, size_t last) {
+			for (size_t i = start + first; i < start + last; i++)
+			{
+				const Entity& entity = scene->entities[i];
+				if (IsEntityValid(entity.id) && (all || componentMask == (componentMask & entity.mask)))
+				{
+					func(entity.id, *scene->template GetUnchecked<ComponentTypes>(entity.id)...);
+				}
+			}
+		});
+	}
+
+	/**
+	 * @brief Look up the membership bitmaps of the requested components in the scene
+	 *
+	 * @return true True if every component has a bitmap
+	 * @return false False if a component was never assigned, so no entity can match
+	 */
+	bool FetchBitmaps() const
+	{
+		int componentIds[] = { 0, GetId<ComponentTypes>()... };
+		for (size_t i = 0; i < sizeof...(ComponentTypes); i++)
+		{
+			bitmaps[i] = scene->Membership(componentIds[i + 1]);
+			if (bitmaps[i] == nullptr)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Get the owning entities of the smallest sparse set of the requested components
+	 *
+	 * @return const std::vector<EntityID>* Owning entities of the set, null if no component is stored in a sparse set
+	 */
+	const std::vector<EntityID>* SmallestSparseSet() const
+	{
+		if (scene->mode == StorageMode::Archetype)
+		{
+			return nullptr;
+		}
+
+		// Unpack the template parameters into an initializer list
+		const SparseSetBase* sets[] = { nullptr, SparseSetOf<ComponentTypes>()... };
+		const SparseSetBase* smallest = nullptr;
+		for (int i = 1; i < (sizeof...(ComponentTypes) + 1); i++)
+		{
+			if (sets[i] != nullptr && (smallest == nullptr || sets[i]->Size() < smallest->Size()))
+			{
+				smallest = sets[i];
+			}
+		}
+		return smallest != nullptr ? &smallest->denseEntities : nullptr;
+	}
+
+	/**
+	 * @brief Get the sparse set of a component type
+	 *
+	 * @tparam T Type of the component
+	 * @return const SparseSetBase* Sparse set of the type, null if the type is not stored in a sparse set
+	 */
+	template <typename T>
+	const SparseSetBase* SparseSetOf() const
+	{
+		if constexpr (ComponentStorage<T>::type == StorageType::SparseSet)
+		{
+			return scene->template GetSparseSet<T>();
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
+
 	/**
 	 * @brief Scene from which the entities will be gotten
 	 *
@@ -214,4 +612,10 @@ struct SceneView
 	 *
 	 */
 	EntityIndex start;
+
+	/**
+	 * @brief Membership bitmaps of the requested components, looked up when the iteration starts
+	 *
+	 */
+	mutable std::array<const std::uint64_t*, sizeof...(ComponentTypes) + 1> bitmaps;
 };
\ No newline at end of file
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "ecs/ComponentFields.hpp"
+#include "ecs/ComponentPool.hpp"
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Pool used to store components of one type as structure of arrays
+ *
+ * Every field has its own component pool, so the values of one field are contiguous within a chunk. All fields use
+ * the same chunk size, so the same chunk and offset address the fields of one component.
+ *
+ */
+struct SoaPoolBase
+{
+	/**
+	 * @brief Construct a new Soa Pool Base object
+	 *
+	 * @param sizes Size of each field
+	 * @param chunksize Number of components per chunk, rounded up to a power of two
+	 * @param capacity Number of components that storage is reserved for
+	 */
+	SoaPoolBase(std::initializer_list<size_t> sizes, size_t chunksize, size_t capacity)
+	{
+		for (size_t size : sizes)
+		{
+			fields.push_back(new ComponentPool(size, chunksize, capacity));
+		}
+	}
+
+	/**
+	 * @brief The pool owns its field pools and can therefore not be copied
+	 *
+	 */
+	SoaPoolBase(const SoaPoolBase&) = delete;
+	SoaPoolBase& operator=(const SoaPoolBase&) = delete;
+
+	/**
+	 * @brief Destroy the Soa Pool Base object
+	 *
+	 */
+	virtual ~SoaPoolBase()
+	{
+		for (ComponentPool* field : fields)
+		{
+			delete field;
+		}
+	}
+
+	/**
+	 * @brief Make sure the pool can hold the specified number of components
+	 *
+	 * @param count Number of components
+	 */
+	void Reserve(size_t count)
+	{
+		for (ComponentPool* field : fields)
+		{
+			field->Reserve(count);
+		}
+	}
+
+	/**
+	 * @brief Get the number of chunks
+	 *
+	 * @return size_t Number of chunks of every field
+	 */
+	inline size_t ChunkCount() const
+	{
+		return fields[0]->chunks.size();
+	}
+
+	/**
+	 * @brief Get the number of components per chunk
+	 *
+	 * @return size_t Number of components per chunk
+	 */
+	inline size_t ChunkSize() const
+	{
+		return fields[0]->chunkMask + 1;
+	}
+
+	/**
+	 * @brief One pool per field, in the order the fields are listed
+	 *
+	 */
+	std::vector<ComponentPool*> fields;
+};
+
+/**
+ * @brief Structure of arrays pool of one component type
+ *
+ * @tparam T Type of the components. Must be declared with SOA_FIELDS
+ */
+template <typename T>
+struct SoaPool : SoaPoolBase
+{
+	typedef typename ComponentFields<T>::Ref Ref;
+
+	/**
+	 * @brief Type of a field
+	 *
+	 * @tparam I Index of the field
+	 */
+	template <size_t I>
+	using FieldType = std::remove_reference_t<decltype(std::declval<Ref>().Field(FieldIndex<I>()))>;
+
+	/**
+	 * @brief Construct a new Soa Pool object
+	 *
+	 * @param chunksize Number of components per chunk, rounded up to a power of two
+	 * @param capacity Number of components that storage is reserved for
+	 */
+	SoaPool(size_t chunksize, size_t capacity) :
+		SoaPool(chunksize, capacity, std::make_index_sequence<ComponentFields<T>::COUNT>())
+	{
+	}
+
+	/**
+	 * @brief Get the references to the fields of the component at the specified index
+	 *
+	 * @param index Index of the component. Must be below the reserved count
+	 * @return Ref References to the fields
+	 */
+	inline Ref At(size_t index)
+	{
+		return At(index, std::make_index_sequence<ComponentFields<T>::COUNT>());
+	}
+
+	/**
+	 * @brief Get the values of one field of a chunk, for loops that process many components at once
+	 *
+	 * @tparam I Index of the field
+	 * @param chunk Index of the chunk
+	 * @return FieldType<I>* Array of ChunkSize values
+	 */
+	template <size_t I>
+	inline FieldType<I>* Column(size_t chunk)
+	{
+		return reinterpret_cast<FieldType<I>*>(fields[I]->chunks[chunk]);
+	}
+
+	/**
+	 * @brief Construct the field pools, with the size of each field
+	 *
+	 */
+	template <size_t... I>
+	SoaPool(size_t chunksize, size_t capacity, std::index_sequence<I...>) :
+		SoaPoolBase({ sizeof(FieldType<I>)... }, chunksize, capacity)
+	{
+	}
+
+	/**
+	 * @brief Get the references to the fields of the component at the specified index, one field per index
+	 *
+	 */
+	template <size_t... I>
+	inline Ref At(size_t index, std::index_sequence<I...>)
+	{
+		return Ref { *fields[I]->template get<FieldType<I>>(index)... };
+	}
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "ecs/Util.hpp"
+#include <vector>
+
+/**
+ * @brief Type independent part of a sparse set, used by the scene to manage sets of different component types
+ *
+ */
+struct SparseSetBase
+{
+	/**
+	 * @brief Destroy the Sparse Set Base object
+	 *
+	 */
+	virtual ~SparseSetBase() = default;
+
+	/**
+	 * @brief Remove the component of the specified entity
+	 *
+	 * @param index Index of the entity
+	 */
+	virtual void Remove(EntityIndex index) = 0;
+
+	/**
+	 * @brief Check if the set contains a component for the specified entity
+	 *
+	 * @param index Index of the entity
+	 * @return true True if the entity has a component in this set
+	 * @return false False if the entity has no component in this set
+	 */
+	inline bool Contains(EntityIndex index) const
+	{
+		return index < sparse.size() && sparse[index] != INVALID_SLOT;
+	}
+
+	/**
+	 * @brief Get the number of components in this set
+	 *
+	 * @return size_t Number of components
+	 */
+	inline size_t Size() const
+	{
+		return denseEntities.size();
+	}
+
+	/**
+	 * @brief Marker for entities that have no component in this set
+	 *
+	 */
+	static constexpr EntityIndex INVALID_SLOT = EntityIndex(-1);
+
+	/**
+	 * @brief Slot in the dense arrays for each entity index
+	 *
+	 */
+	std::vector<EntityIndex> sparse;
+
+	/**
+	 * @brief Owning entity of each component, packed in the same order as the components
+	 *
+	 */
+	std::vector<EntityID> denseEntities;
+};
+
+/**
+ * @brief Set used to store components of one type densely packed, without holes for entities that don't have one
+ *
+ * Adding and removing a component is O(1). Removing moves the last component into the freed slot, so pointers
+ * to components of this set are only valid until the next component is assigned or removed.
+ *
+ * @tparam T Type of the components
+ */
+template <typename T>
+struct SparseSet : SparseSetBase
+{
+	/**
+	 * @brief Construct a component for the specified entity. An existing component of the entity is replaced
+	 *
+	 * @param id ID of the entity
+	 * @return T* Pointer to the component
+	 */
+	T* Emplace(EntityID id)
+	{
+		EntityIndex index = GetEntityIndex(id);
+		if (Contains(index))
+		{
+			EntityIndex slot = sparse[index];
+			denseEntities[slot] = id;
+			dense[slot] = T();
+			return &dense[slot];
+		}
+
+		if (sparse.size() <= index)
+		{
+			sparse.resize(index + 1, INVALID_SLOT);
+		}
+
+		// Append the component to the end of the packed arrays
+		sparse[index] = EntityIndex(dense.size());
+		denseEntities.push_back(id);
+		dense.emplace_back();
+		return &dense.back();
+	}
+
+	/**
+	 * @brief Get the component of the specified entity. The entity must have a component in this set
+	 *
+	 * @param index Index of the entity
+	 * @return T* Pointer to the component
+	 */
+	inline T* Get(EntityIndex index)
+	{
+		return &dense[sparse[index]];
+	}
+
+	/**
+	 * @brief Remove the component of the specified entity
+	 *
+	 * @param index Index of the entity
+	 */
+	void Remove(EntityIndex index) override
+	{
+		if (!Contains(index))
+		{
+			return;
+		}
+
+		// Move the last component into the freed slot, so the arrays stay packed
+		EntityIndex slot = sparse[index];
+		EntityIndex last = EntityIndex(dense.size() - 1);
+		if (slot != last)
+		{
+			dense[slot] = std::move(dense[last]);
+			denseEntities[slot] = denseEntities[last];
+			sparse[GetEntityIndex(denseEntities[slot])] = slot;
+		}
+
+		dense.pop_back();
+		denseEntities.pop_back();
+		sparse[index] = INVALID_SLOT;
+	}
+
+	/**
+	 * @brief Components of this set, packed without holes
+	 *
+	 */
+	std::vector<T> dense;
+};
\ No newline at end of file
@@ -0,0 +1,292 @@
+#pragma once
+
+#include "Profiler.hpp"
+#include "ecs/ThreadPool.hpp"
+#include "ecs/Util.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Components that a system reads and writes, which decides which systems can run at the same time
+ *
+ */
+struct SystemAccess
+{
+	/**
+	 * @brief Components that the system only reads
+	 *
+	 */
+	ComponentMask reads;
+
+	/**
+	 * @brief Components that the system writes
+	 *
+	 */
+	ComponentMask writes;
+
+	/**
+	 * @brief Flag if the system adds or removes components or entities, which conflicts with every other system
+	 *
+	 */
+	bool structural { false };
+
+	/**
+	 * @brief Flag if the system has to run on the thread that runs the scheduler, e.g. because it draws to a window
+	 *
+	 */
+	bool mainThread { false };
+
+	/**
+	 * @brief Check if two systems can not run at the same time
+	 *
+	 * @param other Access of the other system
+	 * @return true True if one system writes what the other one reads or writes, or one of them is structural
+	 * @return false False if both systems can run at the same time
+	 */
+	inline bool ConflictsWith(const SystemAccess& other) const
+	{
+		return structural || other.structural || (writes & (other.reads | other.writes)).any() || (other.writes & reads).any();
+	}
+};
+
+/**
+ * @brief Scheduler that runs the systems of a frame on a thread pool
+ *
+ * Systems run in the order they were added, except that systems which don't conflict run at the same time.
+ * Every system waits for all earlier systems it conflicts with, which makes the result the same as running the
+ * systems one after another.
+ *
+ */
+struct SystemScheduler
+{
+	/**
+	 * @brief Construct a new System Scheduler object
+	 *
+	 * @param pool Thread pool that runs the systems
+	 */
+	SystemScheduler(ThreadPool& pool) :
+		pool(&pool)
+	{
+	}
+
+	/**
+	 * @brief Add a system that runs every frame after the systems added before it that it conflicts with
+	 *
+	 * @param name Name of the system
+	 * @param access Components that the system reads and writes
+	 * @param run Function that updates the system
+	 * @param entities Function that returns the number of entities the system processes, only called when profiling
+	 */
+	void Add(const std::string& name, const SystemAccess& access, std::function<void()> run, std::function<size_t()> entities = nullptr)
+	{
+		std::unique_ptr<System> system(new System());
+		system->name = name;
+		system->access = access;
+		system->run = std::move(run);
+		system->entities = std::move(entities);
+		if (profiler != nullptr)
+		{
+			system->section = profiler->Section(name);
+		}
+
+		// Depend on every earlier system that conflicts with this one
+		for (size_t i = 0; i < systems.size(); i++)
+		{
+			if (systems[i]->access.ConflictsWith(access))
+			{
+				systems[i]->successors.push_back(systems.size());
+				system->dependencies++;
+			}
+		}
+		systems.push_back(std::move(system));
+	}
+
+	/**
+	 * @brief Time every system with a profiler, in a section with the name of the system
+	 *
+	 * @param profiler Profiler that records the times, null to stop profiling
+	 */
+	void Profile(Profiler* profiler)
+	{
+		this->profiler = profiler;
+		for (std::unique_ptr<System>& system : systems)
+		{
+			system->section = profiler != nullptr ? profiler->Section(system->name) : 0;
+		}
+	}
+
+	/**
+	 * @brief Run all systems once and return when all of them finished
+	 *
+	 */
+	void Run()
+	{
+		pending.store(systems.size(), std::memory_order_relaxed);
+		for (std::unique_ptr<System>& system : systems)
+		{
+			system->remaining.store(system->dependencies, std::memory_order_relaxed);
+		}
+		for (size_t i = 0; i < systems.size(); i++)
+		{
+			if (systems[i]->dependencies == 0)
+			{
+				Dispatch(i);
+			}
+		}
+
+		// Run the systems that are bound to this thread, and help the pool with the others
+		while (pending.load(std::memory_order_acquire) > 0)
+		{
+			size_t system = systems.size();
+			{
+				std::lock_guard<std::mutex> lock(mainMutex);
+				if (!mainReady.empty())
+				{
+					system = mainReady.back();
+					mainReady.pop_back();
+				}
+			}
+			if (system < systems.size())
+			{
+				Execute(system);
+			}
+			else if (!pool->RunOne())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	/**
+	 * @brief Hand a system whose dependencies finished to the thread that has to run it
+	 *
+	 * @param index Index of the system
+	 */
+	void Dispatch(size_t index)
+	{
+		if (systems[index]->access.mainThread)
+		{
+			std::lock_guard<std::mutex> lock(mainMutex);
+			mainReady.push_back(index);
+			return;
+		}
+		pool->Submit([this, index] { Execute(index); });
+	}
+
+	/**
+	 * @brief Run a system and release the systems that waited for it
+	 *
+	 * @param index Index of the system
+	 */
+	void Execute(size_t index)
+	{
+		System& system = *systems[index];
+		{
+			ScopedTimer timer(profiler, system.section, profiler != nullptr && system.entities ? system.entities() : 0);
+			system.run();
+		}
+		for (size_t successor : system.successors)
+		{
+			if (systems[successor]->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				Dispatch(successor);
+			}
+		}
+		pending.fetch_sub(1, std::memory_order_release);
+	}
+
+	/**
+	 * @brief System that was added to the scheduler
+	 *
+	 */
+	struct System
+	{
+		/**
+		 * @brief Name of the system
+		 *
+		 */
+		std::string name;
+
+		/**
+		 * @brief Components that the system reads and writes
+		 *
+		 */
+		SystemAccess access;
+
+		/**
+		 * @brief Function that updates the system
+		 *
+		 */
+		std::function<void()> run;
+
+		/**
+		 * @brief Function that returns the number of entities the system processes, can be empty
+		 *
+		 */
+		std::function<size_t()> entities;
+
+		/**
+		 * @brief Index of the section of the system in the profiler
+		 *
+		 */
+		size_t section { 0 };
+
+		/**
+		 * @brief Systems that wait for this system
+		 *
+		 */
+		std::vector<size_t> successors;
+
+		/**
+		 * @brief Number of systems this system waits for
+		 *
+		 */
+		size_t dependencies { 0 };
+
+		/**
+		 * @brief Number of systems this system still waits for in the current frame
+		 *
+		 */
+		std::atomic<size_t> remaining { 0 };
+	};
+
+	/**
+	 * @brief Thread pool that runs the systems
+	 *
+	 */
+	ThreadPool* pool;
+
+	/**
+	 * @brief Systems in the order they were added
+	 *
+	 */
+	std::vector<std::unique_ptr<System>> systems;
+
+	/**
+	 * @brief Profiler that times the systems, null if they are not timed
+	 *
+	 */
+	Profiler* profiler { nullptr };
+
+	/**
+	 * @brief Number of systems that did not finish in the current frame
+	 *
+	 */
+	std::atomic<size_t> pending { 0 };
+
+	/**
+	 * @brief Mutex that guards the systems that are ready to run on the thread of the scheduler
+	 *
+	 */
+	std::mutex mainMutex;
+
+	/**
+	 * @brief Systems that are ready to run on the thread of the scheduler
+	 *
+	 */
+	std::vector<size_t> mainReady;
+};
\ No newline at end of file
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Pool of worker threads that run tasks, with one task queue per worker
+ *
+ * Workers take new tasks from the back of their own queue and steal from the front of the other queues when
+ * theirs is empty. Threads that wait for tasks to finish help running them, so waiting never blocks a worker.
+ *
+ */
+struct ThreadPool
+{
+	/**
+	 * @brief Construct a new Thread Pool object
+	 *
+	 * @param threads Number of worker threads. The thread that waits for tasks also runs them, so the default
+	 * leaves one hardware thread for it
+	 */
+	ThreadPool(unsigned int threads = std::max(std::thread::hardware_concurrency(), 1u) - 1)
+	{
+		// There is always one queue, so tasks can be queued even without workers
+		for (unsigned int i = 0; i < std::max(threads, 1u); i++)
+		{
+			queues.emplace_back(new Queue());
+		}
+		for (unsigned int i = 0; i < threads; i++)
+		{
+			workers.emplace_back(&ThreadPool::Work, this, i);
+		}
+	}
+
+	/**
+	 * @brief The pool owns its threads and can therefore not be copied
+	 *
+	 */
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	 * @brief Destroy the Thread Pool object after its workers finished their current tasks
+	 *
+	 */
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	/**
+	 * @brief Queue a task. Tasks queued by a worker go to its own queue, others are spread over all queues
+	 *
+	 * @param task Task that will be run by one of the threads
+	 */
+	void Submit(std::function<void()> task)
+	{
+		// Count the task first, so taking it can never make the count drop below zero
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			queued++;
+		}
+		size_t queue = s_pool == this ? s_worker : next++ % queues.size();
+		{
+			std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+			queues[queue]->tasks.push_back(std::move(task));
+		}
+		wake.notify_one();
+	}
+
+	/**
+	 * @brief Run one queued task on the calling thread, if there is one
+	 *
+	 * @return true True if a task was run
+	 * @return false False if all queues were empty
+	 */
+	bool RunOne()
+	{
+		size_t own = s_pool == this ? s_worker : 0;
+		std::function<void()> task;
+		if (!Pop(own, task))
+		{
+			return false;
+		}
+		task();
+		return true;
+	}
+
+	/**
+	 * @brief Run queued tasks on the calling thread until a counter of unfinished tasks reaches zero
+	 *
+	 * @param pending Number of unfinished tasks that the finishing tasks count down
+	 */
+	void Wait(const std::atomic<size_t>& pending)
+	{
+		while (pending.load(std::memory_order_acquire) > 0)
+		{
+			if (!RunOne())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	/**
+	 * @brief Split a range into chunks and run a function for every chunk on all threads of the pool
+	 *
+	 * The calling thread runs the first chunk and then helps with the others until all of them finished.
+	 *
+	 * @tparam Func Type of the function
+	 * @param count Number of elements in the range
+	 * @param grain Number of elements per chunk
+	 * @param func Function that is called as func(first, last) for every chunk
+	 */
+	template <typename Func>
+	void ParallelFor(size_t count, size_t grain, Func func)
+	{
+		grain = std::max<size_t>(grain, 1);
+		size_t chunks = (count + grain - 1) / grain;
+		if (chunks <= 1)
+		{
+			if (count > 0)
+			{
+				func(size_t(0), count);
+			}
+			return;
+		}
+
+		// The function and the counter live on this stack, which Wait keeps alive until every chunk finished
+		std::atomic<size_t> pending { chunks };
+		for (size_t chunk = 1; chunk < chunks; chunk++)
+		{
+			Submit([&, chunk] {
+				func(chunk * grain, std::min(count, (chunk + 1) * grain));
+				pending.fetch_sub(1, std::memory_order_release);
+			});
+		}
+		func(size_t(0), grain);
+		pending.fetch_sub(1, std::memory_order_release);
+		Wait(pending);
+	}
+
+	/**
+	 * @brief Get the index of the calling thread, which is unique among the threads of one pool
+	 *
+	 * @return size_t One plus the index of the worker, or zero if this thread is no worker
+	 */
+	static inline size_t ThreadIndex()
+	{
+		return s_pool != nullptr ? s_worker + 1 : 0;
+	}
+
+	/**
+	 * @brief Get the number of per thread slots that work needs, which the calling thread splits over a pool
+	 *
+	 * @param pool Pool that runs the work, null if the calling thread runs it alone
+	 * @return size_t One more than the highest ThreadIndex that can run the work
+	 */
+	static inline size_t SlotCount(const ThreadPool* pool)
+	{
+		return std::max(pool != nullptr ? pool->ThreadCount() : 1, ThreadIndex() + 1);
+	}
+
+	/**
+	 * @brief Get the number of threads that run tasks, including the one that waits for them
+	 *
+	 * @return size_t Number of threads
+	 */
+	inline size_t ThreadCount() const
+	{
+		return workers.size() + 1;
+	}
+
+	/**
+	 * @brief Tasks of one worker
+	 *
+	 */
+	struct Queue
+	{
+		/**
+		 * @brief Mutex that guards the tasks
+		 *
+		 */
+		std::mutex mutex;
+
+		/**
+		 * @brief Queued tasks. The owner works at the back, other threads steal from the front
+		 *
+		 */
+		std::deque<std::function<void()>> tasks;
+	};
+
+	/**
+	 * @brief Take a task from the back of a queue, or steal one from the front of another queue
+	 *
+	 * @param own Index of the queue that is checked first
+	 * @param task Task that was taken
+	 * @return true True if a task was taken
+	 * @return false False if all queues were empty
+	 */
+	bool Pop(size_t own, std::function<void()>& task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(queues[own]->mutex);
+			if (!queues[own]->tasks.empty())
+			{
+				task = std::move(queues[own]->tasks.back());
+				queues[own]->tasks.pop_back();
+				queued--;
+				return true;
+			}
+		}
+		for (size_t i = 1; i < queues.size(); i++)
+		{
+			Queue& victim = *queues[(own + i) % queues.size()];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.tasks.empty())
+			{
+				task = std::move(victim.tasks.front());
+				victim.tasks.pop_front();
+				queued--;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Loop of a worker thread
+	 *
+	 * @param index Index of the worker and its queue
+	 */
+	void Work(size_t index)
+	{
+		s_pool = this;
+		s_worker = index;
+		while (true)
+		{
+			if (RunOne())
+			{
+				continue;
+			}
+
+			// Sleep until a task was queued or the pool is destroyed
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			wake.wait(lock, [&] { return stopping || queued > 0; });
+			if (stopping)
+			{
+				return;
+			}
+		}
+	}
+
+	/**
+	 * @brief Pool of the worker running on this thread, null if this thread is no worker
+	 *
+	 */
+	static inline thread_local ThreadPool* s_pool { nullptr };
+
+	/**
+	 * @brief Index of the worker running on this thread
+	 *
+	 */
+	static inline thread_local size_t s_worker { 0 };
+
+	/**
+	 * @brief One task queue per worker
+	 *
+	 */
+	std::vector<std::unique_ptr<Queue>> queues;
+
+	/**
+	 * @brief Worker threads
+	 *
+	 */
+	std::vector<std::thread> workers;
+
+	/**
+	 * @brief Number of tasks in all queues
+	 *
+	 */
+	std::atomic<size_t> queued { 0 };
+
+	/**
+	 * @brief Queue that the next task submitted from outside of the pool goes to
+	 *
+	 */
+	std::atomic<size_t> next { 0 };
+
+	/**
+	 * @brief Mutex that guards sleeping and waking the workers
+	 *
+	 */
+	std::mutex sleepMutex;
+
+	/**
+	 * @brief Wakes sleeping workers when tasks are queued
+	 *
+	 */
+	std::condition_variable wake;
+
+	/**
+	 * @brief Flag if the pool is being destroyed
+	 *
+	 */
+	bool stopping { false };
+};
\ No newline at end of file
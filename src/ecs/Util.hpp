@@ -2,12 +2,6 @@
 
 #include <bitset>
 
-/**
- * @brief Maximum number of entities
- *
- */
-#define NUM_OF_ENTITIES (500)
-
 /**
  * @brief Create an invalid entity
  *
@@ -63,6 +57,75 @@ int GetId()
 	return s_componentId;
 }
 
+/**
+ * @brief Get the mask of a set of component types
+ *
+ * @tparam T Types of the components
+ * @return ComponentMask Mask with the bits of all types set
+ */
+template <class... T>
+ComponentMask MaskOf()
+{
+	ComponentMask mask;
+	(mask.set(GetId<T>()), ...);
+	return mask;
+}
+
+/**
+ * @brief Ways in which the components of one type can be stored in a scene
+ *
+ */
+enum class StorageType
+{
+	/**
+	 * @brief Components are stored in a pool with one slot per entity
+	 *
+	 */
+	Pool,
+
+	/**
+	 * @brief Components are packed in a sparse set, which makes adding and removing them cheap
+	 *
+	 */
+	SparseSet,
+
+	/**
+	 * @brief Every field of the components has its own pool, so loops over one field read contiguous memory
+	 *
+	 */
+	SoA
+};
+
+/**
+ * @brief Ways in which a scene can store the components of its entities
+ *
+ */
+enum class StorageMode
+{
+	/**
+	 * @brief Every component type has its own storage, as selected by ComponentStorage
+	 *
+	 */
+	PerComponent,
+
+	/**
+	 * @brief Entities with the same component mask are stored together in one archetype table
+	 *
+	 */
+	Archetype
+};
+
+/**
+ * @brief Storage used for a component type. Specialize this for components that should not use the default pool
+ *
+ * @tparam T Type of the component
+ */
+template <class T>
+struct ComponentStorage
+{
+	static constexpr StorageType type = StorageType::Pool;
+};
+
 /**
  * @brief Create a new entity ID
  *
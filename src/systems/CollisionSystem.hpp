@@ -1,45 +1,388 @@
 #pragma once
 
+#include "SpatialGrid.hpp"
+#include "SpatialIndex.hpp"
+#include "Utility/RadixSort.hpp"
 #include "World.hpp"
 #include "components/Collision.hpp"
 #include "components/Position.hpp"
 #include "ecs/Scene.hpp"
 #include "ecs/SceneView.hpp"
+#include "ecs/SystemScheduler.hpp"
+#include <algorithm>
+
+/**
+ * @brief Ways in which the collision system finds entities in the same position
+ *
+ */
+enum class CollisionMode
+{
+	/**
+	 * @brief Compare every entity with every other entity
+	 *
+	 */
+	BruteForce,
+
+	/**
+	 * @brief Sort the entities into a uniform grid and only compare entities in the same cell
+	 *
+	 */
+	Grid,
+
+	/**
+	 * @brief Use a spatial index that other systems keep up to date and only compare entities in crowded cells.
+	 * Entities are only found once their position was published to the index
+	 *
+	 */
+	Incremental,
+
+	/**
+	 * @brief Radix sort the entities by a key computed from their position and compare runs of equal keys
+	 *
+	 */
+	SortAndSweep
+};
 
 /**
  * @brief System that handles entity collision
  *
+ * An entity collides if another entity with a higher index is in the same position.
+ *
  */
 struct CollisionSystem
 {
+	/**
+	 * @brief Construct a new Collision System object
+	 *
+	 * @param mode Way in which colliding entities are found
+	 * @param cellSize Size of one grid cell in world units, at least 1
+	 */
+	CollisionSystem(CollisionMode mode = CollisionMode::Grid, int cellSize = 4) :
+		mode(mode),
+		cellSize(std::max(cellSize, 1))
+	{
+	}
+
+	/**
+	 * @brief Construct a new Collision System object that uses a spatial index kept up to date by other systems
+	 *
+	 * @param index Spatial index that the positions of the entities are published to
+	 */
+	CollisionSystem(SpatialIndex& index) :
+		mode(CollisionMode::Incremental),
+		cellSize(index.cellSize),
+		index(&index)
+	{
+	}
+
+	/**
+	 * @brief Get the components that the system reads and writes
+	 *
+	 * @return SystemAccess Access of the system
+	 */
+	static SystemAccess Access()
+	{
+		SystemAccess access { MaskOf<Position>(), MaskOf<Collision>() };
+
+		// Assigns collisions, which changes the storage other systems iterate
+		access.structural = true;
+		return access;
+	}
+
 	/**
 	 * @brief Update the system
 	 *
 	 * @param scene Scene that provides entities and components
 	 * @param dt Delta time between two updates
+	 * @param world World in which the entities move
 	 */
-	void update(Scene& scene, float dt)
+	void update(Scene& scene, float dt, World& world)
+	{
+		switch (mode)
+		{
+			case CollisionMode::BruteForce:
+				updateBruteForce(scene);
+				break;
+			case CollisionMode::Grid:
+				updateGrid(scene, world);
+				break;
+			case CollisionMode::Incremental:
+				updateIncremental(scene);
+				break;
+			case CollisionMode::SortAndSweep:
+				updateSortAndSweep(scene);
+				break;
+		}
+	}
+
+	/**
+	 * @brief Find collisions by comparing every entity with every other entity
+	 *
+	 * @param scene Scene that provides entities and components
+	 */
+	void updateBruteForce(Scene& scene)
 	{
 		// Iterate over every entity
 		for (auto entity : SceneView<Position>(scene))
 		{
-			auto position = scene.Get<Position>(entity);
+			auto position = scene.GetUnchecked<Position>(entity);
 
 			// Iterate over every other entity
 			for (auto otherEntity : SceneView<Position>(scene, GetEntityIndex(entity)))
 			{
-				auto otherPosition = scene.Get<Position>(otherEntity);
+				auto otherPosition = scene.GetUnchecked<Position>(otherEntity);
 
 				// If the entities are not the same and in the same position, add a collision component
 				if (entity != otherEntity)
 				{
 					if (position->x == otherPosition->x && position->y == otherPosition->y)
 					{
-						auto collision = scene.Assign<Collision>(entity);
-						collision->damage = 1;
+						collided.push_back(entity);
+
+						// Further collisions would assign the same component again
+						break;
 					}
 				}
 			}
 		}
+		assignCollisions(scene);
+	}
+
+	/**
+	 * @brief Find collisions by sorting the entities into a grid and comparing the entities of each cell
+	 *
+	 * @param scene Scene that provides entities and components
+	 * @param world World in which the entities move
+	 */
+	void updateGrid(Scene& scene, World& world)
+	{
+		grid.Resize(world, cellSize);
+		grid.Build(scene);
+
+		// Only entities in the same cell can be in the same position
+		for (size_t cell = 0; cell < grid.CellCount(); cell++)
+		{
+			collideCell(grid.entries.data() + grid.cellStart[cell], grid.entries.data() + grid.cellStart[cell + 1]);
+		}
+		assignCollisions(scene);
+	}
+
+	/**
+	 * @brief Find collisions by comparing the entities of the cells of the spatial index that hold more than one entity
+	 *
+	 * @param scene Scene that provides entities and components
+	 */
+	void updateIncremental(Scene& scene)
+	{
+		index->ApplyMoves();
+		index->RemoveStale(scene);
+
+		for (unsigned int cell : index->crowded)
+		{
+			cellEntries.clear();
+			for (EntityIndex entity = index->heads[cell]; entity != SpatialIndex::NONE; entity = index->next[entity])
+			{
+				EntityID id = index->tracked[entity];
+				cellEntries.push_back({ id, *scene.GetUnchecked<Position>(id) });
+			}
+			collideCell(cellEntries.data(), cellEntries.data() + cellEntries.size());
+		}
+		assignCollisions(scene);
+	}
+
+	/**
+	 * @brief Find collisions by sorting the entities by the Morton code of their position and scanning runs of equal codes
+	 *
+	 * @param scene Scene that provides entities and components
+	 */
+	void updateSortAndSweep(Scene& scene)
+	{
+		sortEntries.clear();
+		SceneView<Position>(scene).ForEach([&](EntityID entity, ComponentRef<Position> position) {
+			sortEntries.push_back({ mortonCode(position.x, position.y), GetEntityIndex(entity) });
+		});
+		util::radixSort(sortEntries, sortScratch);
+
+		// Entities in the same position have the same code, so they end up next to each other
+		size_t count = sortEntries.size();
+		size_t first = 0;
+		while (first < count)
+		{
+			size_t last = first + 1;
+			while (last < count && sortEntries[last].key == sortEntries[first].key)
+			{
+				last++;
+			}
+
+			// Codes only hold 16 bits per axis, so runs are compared by their real positions
+			if (last - first > 1)
+			{
+				cellEntries.clear();
+				for (size_t i = first; i < last; i++)
+				{
+					EntityID id = scene.entities[sortEntries[i].index].id;
+					cellEntries.push_back({ id, *scene.GetUnchecked<Position>(id) });
+				}
+				collideCell(cellEntries.data(), cellEntries.data() + cellEntries.size());
+			}
+			first = last;
+		}
+		assignCollisions(scene);
+	}
+
+	/**
+	 * @brief Interleave the bits of the lower 16 bits of both coordinates of a position
+	 *
+	 * @param x Horizontal position
+	 * @param y Vertical position
+	 * @return std::uint32_t Morton code of the position
+	 */
+	static inline std::uint32_t mortonCode(int x, int y)
+	{
+		return spreadBits(std::uint32_t(x)) | (spreadBits(std::uint32_t(y)) << 1);
+	}
+
+	/**
+	 * @brief Move the lower 16 bits of a value to the even bits
+	 *
+	 * @param value Value that will be spread
+	 * @return std::uint32_t Spread value
+	 */
+	static inline std::uint32_t spreadBits(std::uint32_t value)
+	{
+		value &= 0x0000FFFF;
+		value = (value | (value << 8)) & 0x00FF00FF;
+		value = (value | (value << 4)) & 0x0F0F0F0F;
+		value = (value | (value << 2)) & 0x33333333;
+		value = (value | (value << 1)) & 0x55555555;
+		return value;
 	}
+
+	/**
+	 * @brief Compare the entities of one cell and remember the ones that collide
+	 *
+	 * @param first First entity of the cell
+	 * @param last End of the entities of the cell
+	 */
+	void collideCell(const SpatialGrid::Entry* first, const SpatialGrid::Entry* last)
+	{
+		// If all entities share one position, all but the one with the highest index collide
+		const SpatialGrid::Entry* highest = first;
+		bool samePosition = true;
+		for (const SpatialGrid::Entry* entry = first; entry != last; entry++)
+		{
+			samePosition = samePosition && entry->position.x == first->position.x && entry->position.y == first->position.y;
+			highest = GetEntityIndex(entry->id) > GetEntityIndex(highest->id) ? entry : highest;
+		}
+		if (samePosition)
+		{
+			for (const SpatialGrid::Entry* entry = first; entry != last; entry++)
+			{
+				if (entry != highest)
+				{
+					collided.push_back(entry->id);
+				}
+			}
+			return;
+		}
+
+		for (const SpatialGrid::Entry* entry = first; entry != last; entry++)
+		{
+			for (const SpatialGrid::Entry* other = first; other != last; other++)
+			{
+				if (GetEntityIndex(other->id) > GetEntityIndex(entry->id) && entry->position.x == other->position.x && entry->position.y == other->position.y)
+				{
+					collided.push_back(entry->id);
+					break;
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Assign a collision to every entity that collided in this update
+	 *
+	 * This happens after the search finished, so moving entities between tables can't affect it. The collisions
+	 * are recorded as commands, so they are assigned in the order of the entities.
+	 *
+	 * @param scene Scene that provides entities and components
+	 */
+	void assignCollisions(Scene& scene)
+	{
+		scene.ReserveCommandBuffers(ThreadPool::ThreadIndex() + 1);
+		CommandBuffer& commands = scene.Commands();
+		for (EntityID entity : collided)
+		{
+			commands.Assign<Collision>(entity, { 1 });
+		}
+		collided.clear();
+		scene.Playback();
+	}
+
+	/**
+	 * @brief Way in which colliding entities are found
+	 *
+	 */
+	CollisionMode mode;
+
+	/**
+	 * @brief Size of one grid cell in world units
+	 *
+	 */
+	int cellSize;
+
+	/**
+	 * @brief Grid that sorts the entities by their position
+	 *
+	 */
+	SpatialGrid grid;
+
+	/**
+	 * @brief Spatial index that is used in incremental mode
+	 *
+	 */
+	SpatialIndex* index { nullptr };
+
+	/**
+	 * @brief Entities of the current cell of the spatial index
+	 *
+	 */
+	std::vector<SpatialGrid::Entry> cellEntries;
+
+	/**
+	 * @brief Sort key of an entity in sort and sweep mode
+	 *
+	 */
+	struct SortEntry
+	{
+		/**
+		 * @brief Morton code of the position of the entity
+		 *
+		 */
+		std::uint32_t key;
+
+		/**
+		 * @brief Index of the entity
+		 *
+		 */
+		EntityIndex index;
+	};
+
+	/**
+	 * @brief Entities sorted by their key in sort and sweep mode
+	 *
+	 */
+	std::vector<SortEntry> sortEntries;
+
+	/**
+	 * @brief Buffer used while sorting the entities
+	 *
+	 */
+	std::vector<SortEntry> sortScratch;
+
+	/**
+	 * @brief Entities that collided in this update
+	 *
+	 */
+	std::vector<EntityID> collided;
 };
\ No newline at end of file
@@ -3,8 +3,11 @@
 #include "World.hpp"
 #include "components/Collision.hpp"
 #include "components/Health.hpp"
+#include "ecs/Query.hpp"
 #include "ecs/Scene.hpp"
 #include "ecs/SceneView.hpp"
+#include "ecs/SystemScheduler.hpp"
+#include <memory>
 
 /**
  * @brief System that handles damage to entities
@@ -12,6 +15,30 @@
  */
 struct DamageSystem
 {
+	/**
+	 * @brief Construct a new Damage System object
+	 *
+	 * @param pool Thread pool that damages the entities in parallel, can be null
+	 */
+	DamageSystem(ThreadPool* pool = nullptr) :
+		pool(pool)
+	{
+	}
+
+	/**
+	 * @brief Get the components that the system reads and writes
+	 *
+	 * @return SystemAccess Access of the system
+	 */
+	static SystemAccess Access()
+	{
+		SystemAccess access { ComponentMask(), MaskOf<Health, Collision>() };
+
+		// Removes collisions, which changes the storage other systems iterate
+		access.structural = true;
+		return access;
+	}
+
 	/**
 	 * @brief Update the system
 	 *
@@ -20,15 +47,48 @@ struct DamageSystem
 	 */
 	void update(Scene& scene, float dt)
 	{
-		// Iterate over every entity
-		for (auto entity : SceneView<Health, Collision>(scene))
+		scene.ReserveCommandBuffers(ThreadPool::SlotCount(pool));
+
+		// Few entities collide, so they are kept in a cached query instead of searching them every frame
+		if (query == nullptr || query->scene != &scene)
 		{
-			auto health = scene.Get<Health>(entity);
-			auto collision = scene.Get<Collision>(entity);
+			query.reset(new Query<Health, Collision>(scene));
+		}
 
+		// Iterate over every entity
+		auto damage = [&](EntityID entity, Health& health, Collision& collision) {
 			// Apply damage and remove the collision component
-			health->health -= collision->damage;
-			scene.Remove<Collision>(entity);
+			health.health -= collision.damage;
+			scene.Commands().Remove<Collision>(entity);
+		};
+		if (pool != nullptr)
+		{
+			query->ParallelForEach(*pool, damage, grain);
+		}
+		else
+		{
+			query->ForEach(damage);
 		}
+
+		// Remove the collisions once nothing iterates the scene anymore
+		scene.Playback();
 	}
+
+	/**
+	 * @brief Thread pool that damages the entities in parallel, can be null
+	 *
+	 */
+	ThreadPool* pool { nullptr };
+
+	/**
+	 * @brief Entities that have health and collided
+	 *
+	 */
+	std::unique_ptr<Query<Health, Collision>> query;
+
+	/**
+	 * @brief Number of entities that one thread damages at a time
+	 *
+	 */
+	size_t grain { 4096 };
 };
\ No newline at end of file
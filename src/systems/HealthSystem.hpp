@@ -4,6 +4,7 @@
 #include "components/Health.hpp"
 #include "ecs/Scene.hpp"
 #include "ecs/SceneView.hpp"
+#include "ecs/SystemScheduler.hpp"
 
 /**
  * @brief System that the death of entities
@@ -11,6 +12,30 @@
  */
 struct HealthSystem
 {
+	/**
+	 * @brief Construct a new Health System object
+	 *
+	 * @param pool Thread pool that checks the entities in parallel, can be null
+	 */
+	HealthSystem(ThreadPool* pool = nullptr) :
+		pool(pool)
+	{
+	}
+
+	/**
+	 * @brief Get the components that the system reads and writes
+	 *
+	 * @return SystemAccess Access of the system
+	 */
+	static SystemAccess Access()
+	{
+		SystemAccess access { MaskOf<Health>(), ComponentMask() };
+
+		// Destroys entities, which changes the storage other systems iterate
+		access.structural = true;
+		return access;
+	}
+
 	/**
 	 * @brief Update the system
 	 *
@@ -19,16 +44,38 @@ struct HealthSystem
 	 */
 	void update(Scene& scene, float dt)
 	{
-		// Iterate over every entity
-		for (auto entity : SceneView<Health>(scene))
-		{
-			auto health = scene.Get<Health>(entity);
+		scene.ReserveCommandBuffers(ThreadPool::SlotCount(pool));
 
+		// Iterate over every entity
+		auto check = [&](EntityID entity, Health& health) {
 			// Delete entity if it has no health left
-			if (health->health <= 0)
+			if (health.health <= 0)
 			{
-				scene.DestroyEntity(entity);
+				scene.Commands().Destroy(entity);
 			}
+		};
+		if (pool != nullptr)
+		{
+			SceneView<Health>(scene).ParallelForEach(*pool, check, grain);
 		}
+		else
+		{
+			SceneView<Health>(scene).ForEach(check);
+		}
+
+		// Destroy the entities once nothing iterates the scene anymore
+		scene.Playback();
 	}
+
+	/**
+	 * @brief Thread pool that checks the entities in parallel, can be null
+	 *
+	 */
+	ThreadPool* pool { nullptr };
+
+	/**
+	 * @brief Number of entities that one thread checks at a time
+	 *
+	 */
+	size_t grain { 4096 };
 };
\ No newline at end of file
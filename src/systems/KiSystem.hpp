@@ -1,9 +1,11 @@
 #pragma once
 
+#include "SteeringKernel.hpp"
 #include "World.hpp"
 #include "components/Velocity.hpp"
 #include "ecs/Scene.hpp"
 #include "ecs/SceneView.hpp"
+#include "ecs/SystemScheduler.hpp"
 
 #define MOVEMENT_SPEED (2)
 
@@ -13,6 +15,29 @@
  */
 struct KiSystem
 {
+	/**
+	 * @brief Construct a new Ki System object
+	 *
+	 * @param pool Thread pool that updates the entities in parallel, can be null
+	 * @param seed Seed of the random movements. The same seed gives the same movements, no matter how many threads are used
+	 */
+	KiSystem(ThreadPool* pool = nullptr, std::uint32_t seed = 0) :
+		pool(pool),
+		seed(seed)
+	{
+	}
+
+	/**
+	 * @brief Get the components that the system reads and writes
+	 *
+	 * @return SystemAccess Access of the system
+	 */
+	static SystemAccess Access()
+	{
+		SystemAccess access { ComponentMask(), MaskOf<Velocity>() };
+		return access;
+	}
+
 	/**
 	 * @brief Update the system
 	 *
@@ -21,40 +46,133 @@ struct KiSystem
 	 */
 	void update(Scene& scene, float dt)
 	{
-		// Iterate over every entity
-		for (auto entity : SceneView<Velocity>(scene))
+		unsigned int speed = (unsigned int)(MOVEMENT_SPEED * dt);
+
+		// Every entity draws from a counter based generator keyed by the frame, so no generator state is shared
+		std::uint32_t key = util::randomKey(seed, frame++);
+
+		// Velocities in a structure of arrays pool are steered 64 entities at a time
+		if (scene.mode == StorageMode::PerComponent && scene.config.chunkSize >= STEERING_WORD_ENTITIES)
 		{
-			auto velocity = scene.Get<Velocity>(entity);
+			updateColumns(scene, int(speed), key);
+			return;
+		}
 
+		// Iterate over every entity
+		auto steerEntity = [&](EntityID entity, ComponentRef<Velocity> velocity) {
 			// Get random movement and apply the velocity
-			int randomX = rand() % 3;
-			int randomY = rand() % 3;
-			unsigned int speed = (unsigned int)(MOVEMENT_SPEED * dt);
+			std::uint32_t random = util::counterRandom(key, GetEntityIndex(entity));
+			steer(velocity, speed, RandomDirection(random), RandomDirection(random >> 16));
+		};
+		if (pool != nullptr)
+		{
+			SceneView<Velocity>(scene).ParallelForEach(*pool, steerEntity, grain);
+		}
+		else
+		{
+			SceneView<Velocity>(scene).ForEach(steerEntity);
+		}
+	}
 
-			if (randomX == 0)
-			{
-				velocity->x = speed;
-			}
-			else if (randomX == 1)
-			{
-				velocity->x = -speed;
-			}
-			else if (randomX == 2)
-			{
-				velocity->x = 0;
-			}
-			if (randomY == 0)
-			{
-				velocity->y = speed;
-			}
-			else if (randomY == 1)
-			{
-				velocity->y = -speed;
-			}
-			else if (randomY == 2)
+	/**
+	 * @brief Steer the entities with the vectorized kernel, directly on the arrays of the structure of arrays pool
+	 *
+	 * @param scene Scene that provides entities and components
+	 * @param speed Speed of the movement
+	 * @param key Key of the random numbers of this frame
+	 */
+	void updateColumns(Scene& scene, int speed, std::uint32_t key)
+	{
+		const std::uint64_t* velocities = scene.Membership(GetId<Velocity>());
+		if (velocities == nullptr)
+		{
+			return;
+		}
+		SoaPool<Velocity>* velocityPool = scene.GetSoaPool<Velocity>();
+		size_t chunkSize = velocityPool->ChunkSize();
+
+		auto steerWords = [&](size_t first, size_t last) {
+			for (size_t word = first; word < last; word++)
 			{
-				velocity->y = 0;
+				if (velocities[word] == 0)
+				{
+					continue;
+				}
+				size_t entity = word * STEERING_WORD_ENTITIES;
+				size_t chunk = entity / chunkSize;
+				size_t offset = entity % chunkSize;
+				SteerWord(velocityPool->Column<0>(chunk) + offset, velocityPool->Column<1>(chunk) + offset, velocities[word], std::uint32_t(entity), key, speed);
 			}
+		};
+
+		size_t words = (scene.entities.size() + STEERING_WORD_ENTITIES - 1) / STEERING_WORD_ENTITIES;
+		if (pool != nullptr)
+		{
+			pool->ParallelFor(words, std::max<size_t>(grain / STEERING_WORD_ENTITIES, 1), steerWords);
+		}
+		else
+		{
+			steerWords(0, words);
 		}
 	}
+
+	/**
+	 * @brief Apply a random movement to the velocity of an entity
+	 *
+	 * @param velocity Velocity of the entity
+	 * @param speed Speed of the movement
+	 * @param randomX Random direction in horizontal direction, between 0 and 2
+	 * @param randomY Random direction in vertical direction, between 0 and 2
+	 */
+	static inline void steer(ComponentRef<Velocity> velocity, unsigned int speed, int randomX, int randomY)
+	{
+		if (randomX == 0)
+		{
+			velocity.x = speed;
+		}
+		else if (randomX == 1)
+		{
+			velocity.x = -speed;
+		}
+		else if (randomX == 2)
+		{
+			velocity.x = 0;
+		}
+		if (randomY == 0)
+		{
+			velocity.y = speed;
+		}
+		else if (randomY == 1)
+		{
+			velocity.y = -speed;
+		}
+		else if (randomY == 2)
+		{
+			velocity.y = 0;
+		}
+	}
+
+	/**
+	 * @brief Thread pool that updates the entities in parallel, can be null
+	 *
+	 */
+	ThreadPool* pool { nullptr };
+
+	/**
+	 * @brief Seed of the random movements
+	 *
+	 */
+	std::uint32_t seed { 0 };
+
+	/**
+	 * @brief Number of the next frame, which selects the random numbers of the frame
+	 *
+	 */
+	std::uint32_t frame { 0 };
+
+	/**
+	 * @brief Number of entities that one thread updates at a time
+	 *
+	 */
+	size_t grain { 4096 };
 };
\ No newline at end of file
@@ -1,10 +1,13 @@
 #pragma once
 
+#include "MovementKernel.hpp"
+#include "SpatialIndex.hpp"
 #include "World.hpp"
 #include "components/Position.hpp"
 #include "components/Velocity.hpp"
 #include "ecs/Scene.hpp"
 #include "ecs/SceneView.hpp"
+#include "ecs/SystemScheduler.hpp"
 
 /**
  * @brief System that handles the movement of entities
@@ -12,6 +15,29 @@
  */
 struct MovementSystem
 {
+	/**
+	 * @brief Construct a new Movement System object
+	 *
+	 * @param index Spatial index the new positions are published to, can be null
+	 * @param pool Thread pool that moves the entities in parallel, can be null
+	 */
+	MovementSystem(SpatialIndex* index = nullptr, ThreadPool* pool = nullptr) :
+		index(index),
+		pool(pool)
+	{
+	}
+
+	/**
+	 * @brief Get the components that the system reads and writes
+	 *
+	 * @return SystemAccess Access of the system
+	 */
+	static SystemAccess Access()
+	{
+		SystemAccess access { MaskOf<Velocity>(), MaskOf<Position>() };
+		return access;
+	}
+
 	/**
 	 * @brief Update the system
 	 *
@@ -21,23 +47,137 @@ struct MovementSystem
 	 */
 	void update(Scene& scene, float dt, World& world)
 	{
-		// Iterate over every entity
-		for (auto entity : SceneView<Position, Velocity>(scene))
+		// Every thread that moves entities publishes to its own list of the spatial index
+		if (index != nullptr)
+		{
+			index->ReserveThreads(ThreadPool::SlotCount(pool));
+		}
+
+		// Positions and velocities in structure of arrays pools are moved 64 entities at a time
+		if (scene.mode == StorageMode::PerComponent && scene.config.chunkSize >= MOVEMENT_WORD_ENTITIES)
 		{
-			auto pos = scene.Get<Position>(entity);
-			auto velocity = scene.Get<Velocity>(entity);
+			updateColumns(scene, world);
+			return;
+		}
+
+		// Iterate over every entity
+		int positionId = GetId<Position>();
+		auto move = [&](EntityID entity, ComponentRef<Position> pos, ComponentRef<Velocity> velocity) {
+			bool moved = false;
 
 			// If the horizontal movement is within the world bounds, move
-			if (world.inWorld(pos->x + velocity->x, pos->y))
+			if (world.inWorld(pos.x + velocity.x, pos.y))
 			{
-				pos->x += velocity->x;
+				pos.x += velocity.x;
+				moved |= velocity.x != 0;
 			}
 
 			// If the vertical movement is within the world bounds, move
-			if (world.inWorld(pos->x, pos->y + velocity->y))
+			if (world.inWorld(pos.x, pos.y + velocity.y))
+			{
+				pos.y += velocity.y;
+				moved |= velocity.y != 0;
+			}
+
+			// Let the renderer know that the position changed
+			if (moved)
+			{
+				scene.MarkChanged(positionId, GetEntityIndex(entity));
+			}
+
+			// Let the spatial index know if the entity changed its cell
+			if (index != nullptr)
+			{
+				index->Update(entity, pos);
+			}
+		};
+		if (pool != nullptr)
+		{
+			SceneView<Position, Velocity>(scene).ParallelForEach(*pool, move, grain);
+		}
+		else
+		{
+			SceneView<Position, Velocity>(scene).ForEach(move);
+		}
+	}
+
+	/**
+	 * @brief Move the entities with the vectorized kernel, directly on the arrays of the structure of arrays pools
+	 *
+	 * The membership bitmaps of both components select the entities of each word. The chunks of the pools hold
+	 * at least 64 entities, so a word never crosses a chunk. The kernel returns the entities that actually moved,
+	 * which are marked as changed a whole word at a time.
+	 *
+	 * @param scene Scene that provides entities and components
+	 * @param world World in which the entities move
+	 */
+	void updateColumns(Scene& scene, World& world)
+	{
+		const std::uint64_t* positions = scene.Membership(GetId<Position>());
+		const std::uint64_t* velocities = scene.Membership(GetId<Velocity>());
+		if (positions == nullptr || velocities == nullptr)
+		{
+			return;
+		}
+		SoaPool<Position>* positionPool = scene.GetSoaPool<Position>();
+		SoaPool<Velocity>* velocityPool = scene.GetSoaPool<Velocity>();
+		size_t chunkSize = positionPool->ChunkSize();
+		int positionId = GetId<Position>();
+
+		auto moveWords = [&](size_t first, size_t last) {
+			for (size_t word = first; word < last; word++)
 			{
-				pos->y += velocity->y;
+				std::uint64_t bits = positions[word] & velocities[word];
+				if (bits == 0)
+				{
+					continue;
+				}
+				size_t entity = word * MOVEMENT_WORD_ENTITIES;
+				size_t chunk = entity / chunkSize;
+				size_t offset = entity % chunkSize;
+				std::uint64_t moved = MoveWord(positionPool->Column<0>(chunk) + offset, positionPool->Column<1>(chunk) + offset,
+					velocityPool->Column<0>(chunk) + offset, velocityPool->Column<1>(chunk) + offset,
+					bits, world.sizeX, world.sizeY);
+				scene.MarkChangedWord(positionId, word, moved);
+
+				// Let the spatial index know which entities changed their cell
+				if (index != nullptr)
+				{
+					for (; bits != 0; bits &= bits - 1)
+					{
+						size_t updated = entity + LowestBit(bits);
+						index->Update(scene.entities[updated].id, positionPool->At(updated));
+					}
+				}
 			}
+		};
+
+		size_t words = (scene.entities.size() + MOVEMENT_WORD_ENTITIES - 1) / MOVEMENT_WORD_ENTITIES;
+		if (pool != nullptr)
+		{
+			pool->ParallelFor(words, std::max<size_t>(grain / MOVEMENT_WORD_ENTITIES, 1), moveWords);
+		}
+		else
+		{
+			moveWords(0, words);
 		}
 	}
+
+	/**
+	 * @brief Spatial index the new positions are published to, can be null
+	 *
+	 */
+	SpatialIndex* index { nullptr };
+
+	/**
+	 * @brief Thread pool that moves the entities in parallel, can be null
+	 *
+	 */
+	ThreadPool* pool { nullptr };
+
+	/**
+	 * @brief Number of entities that one thread moves at a time
+	 *
+	 */
+	size_t grain { 4096 };
 };
\ No newline at end of file
@@ -4,6 +4,61 @@
 #include "components/Sprite.hpp"
 #include "ecs/Scene.hpp"
 #include "ecs/SceneView.hpp"
+#include "ecs/SystemScheduler.hpp"
+
+/**
+ * @brief Everything needed to draw one entity
+ *
+ */
+struct SpriteSnapshot
+{
+	/**
+	 * @brief Horizontal position of the entity
+	 *
+	 */
+	float x;
+
+	/**
+	 * @brief Vertical position of the entity
+	 *
+	 */
+	float y;
+
+	/**
+	 * @brief Sprite of the entity, with a radius of 0 if the entity is not drawn anymore
+	 *
+	 */
+	Sprite sprite;
+
+	/**
+	 * @brief Index of the entity, which is also its slot in the vertices of the renderer
+	 *
+	 */
+	EntityIndex slot;
+};
+
+/**
+ * @brief Copy of the entities of a scene that changed since the last snapshot, which does not change while the scene
+ * is updated
+ *
+ * Snapshots only hold the entities whose position or sprite changed, so they have to be drawn in the order they were
+ * captured.
+ *
+ */
+struct RenderSnapshot
+{
+	/**
+	 * @brief Entities that changed, in the order of their slots
+	 *
+	 */
+	std::vector<SpriteSnapshot> sprites;
+
+	/**
+	 * @brief Number of slots at the time of the snapshot, the number of entities of the scene
+	 *
+	 */
+	size_t slots { 0 };
+};
 
 /**
  * @brief System that handles the rendering of entities
@@ -11,6 +66,20 @@
  */
 struct RenderSystem
 {
+	/**
+	 * @brief Get the components that the system reads and writes
+	 *
+	 * @return SystemAccess Access of the system
+	 */
+	static SystemAccess Access()
+	{
+		SystemAccess access { MaskOf<Position>(), MaskOf<Sprite>() };
+
+		// Drawing has to happen on the thread that owns the window
+		access.mainThread = true;
+		return access;
+	}
+
 	/**
 	 * @brief Update the system
 	 *
@@ -20,15 +89,234 @@ struct RenderSystem
 	 */
 	void update(Scene& scene, float dt, sf::RenderWindow& window)
 	{
-		// Iterate over every entity
-		for (auto entity : SceneView<Position, Sprite>(scene))
+		capture(scene, snapshot);
+		draw(snapshot, window);
+	}
+
+	/**
+	 * @brief Copy what is needed to draw the entities into a snapshot, so they can be drawn while the scene changes
+	 *
+	 * The first snapshot holds every entity, later ones only the entities whose position or sprite changed. The
+	 * changes are cleared in the scene once they are captured.
+	 *
+	 * @param scene Scene that provides entities and components
+	 * @param target Snapshot that is overwritten
+	 */
+	void capture(Scene& scene, RenderSnapshot& target)
+	{
+		int positionId = GetId<Position>();
+		int spriteId = GetId<Sprite>();
+		const std::uint64_t* positions = scene.Membership(positionId);
+		const std::uint64_t* sprites = scene.Membership(spriteId);
+		const std::uint64_t* movedPositions = scene.Changed(positionId);
+		const std::uint64_t* changedSprites = scene.Changed(spriteId);
+
+		target.sprites.clear();
+		target.slots = scene.entities.size();
+		for (size_t word = 0; word < (scene.entities.size() + 63) / 64; word++)
+		{
+			std::uint64_t bits = ~std::uint64_t(0);
+			if (!fullCapture)
+			{
+				bits = (movedPositions != nullptr ? movedPositions[word] : 0) | (changedSprites != nullptr ? changedSprites[word] : 0);
+			}
+			std::uint64_t visible = positions != nullptr && sprites != nullptr ? positions[word] & sprites[word] : 0;
+
+			for (; bits != 0; bits &= bits - 1)
+			{
+				EntityIndex index = EntityIndex(word * 64 + LowestBit(bits));
+				if (index >= scene.entities.size())
+				{
+					break;
+				}
+
+				// Entities that lost their position or sprite stay in their slot, but are not drawn
+				SpriteSnapshot entity { 0, 0, Sprite(), index };
+				entity.sprite.radius = 0;
+				if ((visible >> (index & 63)) & 1)
+				{
+					EntityID id = scene.entities[index].id;
+					ComponentPtr<Position> pos = scene.GetUnchecked<Position>(id);
+					entity.x = float(pos->x);
+					entity.y = float(pos->y);
+					entity.sprite = *scene.GetUnchecked<Sprite>(id);
+				}
+				target.sprites.push_back(entity);
+			}
+		}
+
+		scene.ClearChanged(positionId);
+		scene.ClearChanged(spriteId);
+		fullCapture = false;
+	}
+
+	/**
+	 * @brief Apply the changes of a snapshot and draw all entities. Only one thread may draw at a time
+	 *
+	 * The sprites and vertices of all slots are kept between frames, and only the slots of the snapshot are written.
+	 * If vertex buffers are available, the vertices are kept on the GPU as well, and only the runs of changed slots
+	 * are uploaded.
+	 *
+	 * @param source Snapshot of the entities that changed
+	 * @param window Target to draw to
+	 */
+	void draw(const RenderSnapshot& source, sf::RenderTarget& window)
+	{
+		// Slots of new entities are empty until they are part of a snapshot
+		if (slots.size() < source.slots)
+		{
+			SpriteSnapshot empty { 0, 0, Sprite(), 0 };
+			empty.sprite.radius = 0;
+			slots.resize(source.slots, empty);
+			vertices.setPrimitiveType(sf::Quads);
+			vertices.resize(source.slots * 4);
+		}
+
+		size_t runStart = 0, runEnd = 0;
+		for (const SpriteSnapshot& entity : source.sprites)
+		{
+			slots[entity.slot] = entity;
+			writeQuad(entity);
+
+			// Close runs are merged, uploading a few unchanged slots is cheaper than another upload
+			if (runEnd > runStart && entity.slot > runEnd + mergeGap)
+			{
+				upload(runStart, runEnd);
+				runStart = entity.slot;
+			}
+			else if (runEnd == runStart)
+			{
+				runStart = entity.slot;
+			}
+			runEnd = entity.slot + 1;
+		}
+		upload(runStart, runEnd);
+
+		if (!batched)
 		{
-			auto pos = scene.Get<Position>(entity);
-			auto sprite = scene.Get<Sprite>(entity);
+			// Iterate over every entity
+			for (const SpriteSnapshot& entity : slots)
+			{
+				if (entity.sprite.radius == 0)
+				{
+					continue;
+				}
+
+				// Bring the shared shape of the sprite into its state and draw it
+				sf::CircleShape& shape = shapes[entity.sprite.shape];
+				shape.setRadius(entity.sprite.radius);
+				shape.setFillColor(entity.sprite.color);
+				shape.setPosition(entity.x, entity.y);
+				window.draw(shape);
+			}
+			return;
+		}
 
-			// Update position of the sprite and draw it
-			sprite->shape.setPosition(pos->x, pos->y);
-			window.draw(sprite->shape);
+		// Draw the quads of all slots with one draw call
+		if (buffer.getVertexCount() > 0)
+		{
+			window.draw(buffer, 0, slots.size() * 4);
+		}
+		else
+		{
+			window.draw(vertices);
 		}
 	}
+
+	/**
+	 * @brief Write the quad of an entity into its slot of the vertices, covering the bounds of its shape
+	 *
+	 * @param entity Entity with its slot
+	 */
+	void writeQuad(const SpriteSnapshot& entity)
+	{
+		size_t vertex = size_t(entity.slot) * 4;
+		float size = 2 * float(entity.sprite.radius);
+		const sf::Color& color = entity.sprite.color;
+		sf::Vector2f corner(entity.x, entity.y);
+		vertices[vertex++] = sf::Vertex(corner, color);
+		vertices[vertex++] = sf::Vertex(corner + sf::Vector2f(size, 0), color);
+		vertices[vertex++] = sf::Vertex(corner + sf::Vector2f(size, size), color);
+		vertices[vertex++] = sf::Vertex(corner + sf::Vector2f(0, size), color);
+	}
+
+	/**
+	 * @brief Upload the vertices of a run of slots to the vertex buffer, if vertex buffers are available
+	 *
+	 * The buffer grows to twice its size when it runs out of slots, and then all vertices are uploaded.
+	 *
+	 * @param first First slot of the run
+	 * @param last Slot after the last slot of the run
+	 */
+	void upload(size_t first, size_t last)
+	{
+		if (!sf::VertexBuffer::isAvailable())
+		{
+			return;
+		}
+		if (buffer.getVertexCount() < vertices.getVertexCount())
+		{
+			if (!buffer.create(std::max(vertices.getVertexCount(), buffer.getVertexCount() * 2)))
+			{
+				return;
+			}
+			buffer.update(&vertices[0], vertices.getVertexCount(), 0);
+			return;
+		}
+		if (last > first)
+		{
+			buffer.update(&vertices[first * 4], (last - first) * 4, unsigned(first * 4));
+		}
+	}
+
+	/**
+	 * @brief Shapes that sprites refer to by their index, which are only used if the sprites are not batched. The
+	 * first one is a circle
+	 *
+	 */
+	std::vector<sf::CircleShape> shapes { sf::CircleShape() };
+
+	/**
+	 * @brief Flag if all sprites are drawn as quads of one vertex array. Otherwise every shape is drawn on its own,
+	 * which draws exact circles but needs one draw call per entity
+	 *
+	 */
+	bool batched { true };
+
+	/**
+	 * @brief Flag if the next capture holds every entity instead of only the changed ones, e.g. after the scene was
+	 * replaced
+	 *
+	 */
+	bool fullCapture { true };
+
+	/**
+	 * @brief Maximum number of unchanged slots between two changed slots that are uploaded together
+	 *
+	 */
+	size_t mergeGap { 16 };
+
+	/**
+	 * @brief Last drawn state of every slot
+	 *
+	 */
+	std::vector<SpriteSnapshot> slots;
+
+	/**
+	 * @brief Four vertices per slot, the quad of the entity. The quads of slots that are not drawn have no area
+	 *
+	 */
+	sf::VertexArray vertices;
+
+	/**
+	 * @brief Copy of the vertices on the GPU, empty if vertex buffers are not available
+	 *
+	 */
+	sf::VertexBuffer buffer { sf::Quads, sf::VertexBuffer::Stream };
+
+	/**
+	 * @brief Snapshot that update captures and draws right away
+	 *
+	 */
+	RenderSnapshot snapshot;
 };
\ No newline at end of file
@@ -1,6 +1,13 @@
 #define CATCH_CONFIG_RUNNER
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include <catch2/catch.hpp>
 
+/**
+ * @brief Counter of components
+ *
+ */
+int s_componentCounter = 0;
+
 int main(const int argc, const char* argv[])
 {
 	return Catch::Session().run(argc, argv);
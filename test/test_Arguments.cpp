@@ -0,0 +1,28 @@
+#include <catch2/catch.hpp>
+
+#include "Arguments.hpp"
+
+TEST_CASE("Numbers on the command line must be complete and in range", "[arguments]") {
+	std::uint64_t value = 7;
+	REQUIRE(ParseNumber("1000", 1000, value));
+	REQUIRE(value == 1000);
+	REQUIRE(ParseNumber("0", 10, value));
+	REQUIRE(value == 0);
+
+	value = 7;
+	for (const char* invalid : { "", "--help", "12x", "-1", " 5", "1001", "99999999999999999999999" })
+	{
+		REQUIRE_FALSE(ParseNumber(invalid, 1000, value));
+	}
+	REQUIRE(value == 7);
+}
+
+TEST_CASE("Collision modes on the command line must be known", "[arguments]") {
+	CollisionMode mode = CollisionMode::Incremental;
+	REQUIRE(ParseCollisionMode("sort", mode));
+	REQUIRE(mode == CollisionMode::SortAndSweep);
+	REQUIRE(ParseCollisionMode("incremental", mode));
+	REQUIRE(mode == CollisionMode::Incremental);
+	REQUIRE_FALSE(ParseCollisionMode("brutefroce", mode));
+	REQUIRE(mode == CollisionMode::Incremental);
+}
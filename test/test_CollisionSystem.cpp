@@ -0,0 +1,147 @@
+#include <catch2/catch.hpp>
+
+#include "World.hpp"
+#include "components/Collision.hpp"
+#include "components/Position.hpp"
+#include "ecs/Scene.hpp"
+#include "components/Velocity.hpp"
+#include "systems/CollisionSystem.hpp"
+#include "systems/DamageSystem.hpp"
+#include "systems/MovementSystem.hpp"
+
+/**
+ * @brief Create entities in a small world, so many of them share a position
+ *
+ * @param scene Scene the entities are added to
+ * @param world World the entities are spawned in
+ */
+static void SpawnCrowd(Scene& scene, World& world)
+{
+	srand(7);
+	for (int i = 0; i < 2000; i++)
+	{
+		EntityID id = scene.NewEntity();
+		*scene.Assign<Position>(id) = world.getRandomPos();
+	}
+}
+
+/**
+ * @brief Get the IDs of all entities that have a collision
+ *
+ * @param scene Scene that provides entities and components
+ * @return std::set<EntityID> Colliding entities
+ */
+static std::set<EntityID> Collided(Scene& scene)
+{
+	std::set<EntityID> ids;
+	for (EntityID id : SceneView<Collision>(scene))
+	{
+		ids.insert(id);
+	}
+	return ids;
+}
+
+TEST_CASE("Grid collision finds the same collisions as brute force", "[collision]") {
+	World world(40, 30);
+	Scene bruteForce;
+	Scene grid;
+	SpawnCrowd(bruteForce, world);
+	SpawnCrowd(grid, world);
+
+	CollisionSystem(CollisionMode::BruteForce).update(bruteForce, 0, world);
+	CollisionSystem(CollisionMode::Grid, 3).update(grid, 0, world);
+
+	REQUIRE(!Collided(bruteForce).empty());
+	REQUIRE(Collided(bruteForce) == Collided(grid));
+}
+
+TEST_CASE("Cell sizes below one are treated as one", "[collision]") {
+	World world(40, 30);
+	Scene bruteForce;
+	Scene grid;
+	SpawnCrowd(bruteForce, world);
+	SpawnCrowd(grid, world);
+
+	CollisionSystem(CollisionMode::BruteForce).update(bruteForce, 0, world);
+	CollisionSystem(CollisionMode::Grid, 0).update(grid, 0, world);
+	REQUIRE(Collided(bruteForce) == Collided(grid));
+
+	SpatialIndex index(world, -4);
+	REQUIRE(index.cellSize == 1);
+	REQUIRE(index.cellsX == world.sizeX);
+	REQUIRE(index.cellsY == world.sizeY);
+}
+
+TEST_CASE("Sort and sweep collision finds the same collisions as brute force", "[collision]") {
+	World world(40, 30);
+	Scene bruteForce;
+	Scene sorted;
+	SpawnCrowd(bruteForce, world);
+	SpawnCrowd(sorted, world);
+
+	// Positions that only differ above the 16 bits of the sort key must not collide
+	for (Scene* scene : { &bruteForce, &sorted })
+	{
+		*scene->Assign<Position>(scene->NewEntity()) = { 5, 5 };
+		*scene->Assign<Position>(scene->NewEntity()) = { 5 + 65536, 5 };
+	}
+
+	CollisionSystem(CollisionMode::BruteForce).update(bruteForce, 0, world);
+	CollisionSystem(CollisionMode::SortAndSweep).update(sorted, 0, world);
+
+	REQUIRE(!Collided(bruteForce).empty());
+	REQUIRE(Collided(bruteForce) == Collided(sorted));
+}
+
+TEST_CASE("Incremental collision follows moving, destroyed and new entities", "[collision]") {
+	World world(40, 30);
+	Scene bruteForce;
+	Scene incremental;
+	SpatialIndex index(world, 3);
+	ThreadPool pool(3);
+	bool parallel = GENERATE(false, true);
+	MovementSystem bruteForceMovement;
+	MovementSystem incrementalMovement(&index, parallel ? &pool : nullptr);
+	incrementalMovement.grain = 64;
+	CollisionSystem bruteForceCollision(CollisionMode::BruteForce);
+	CollisionSystem incrementalCollision(index);
+
+	for (Scene* scene : { &bruteForce, &incremental })
+	{
+		SpawnCrowd(*scene, world);
+		for (EntityID id : SceneView<Position>(*scene))
+		{
+			auto velocity = scene->Assign<Velocity>(id);
+			velocity->x = int(GetEntityIndex(id) % 3) - 1;
+			velocity->y = int(GetEntityIndex(id) / 3 % 3) - 1;
+		}
+	}
+
+	for (int frame = 0; frame < 20; frame++)
+	{
+		bruteForceMovement.update(bruteForce, 0, world);
+		incrementalMovement.update(incremental, 0, world);
+		bruteForceCollision.update(bruteForce, 0, world);
+		incrementalCollision.update(incremental, 0, world);
+
+		std::set<EntityID> collided = Collided(bruteForce);
+		REQUIRE(collided == Collided(incremental));
+
+		// Destroy the colliding entities and replace some of them, which recycles their indexes
+		int spawned = 0;
+		for (EntityID id : collided)
+		{
+			for (Scene* scene : { &bruteForce, &incremental })
+			{
+				scene->DestroyEntity(id);
+				if (spawned % 2 == 0)
+				{
+					EntityID newId = scene->NewEntity();
+					*scene->Assign<Position>(newId) = { 2 * frame % world.sizeX, frame % world.sizeY };
+					scene->Assign<Velocity>(newId)->x = 1;
+				}
+			}
+			spawned++;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include <catch2/catch.hpp>
+
+#include "SteeringKernel.hpp"
+#include "components/Velocity.hpp"
+#include "ecs/Scene.hpp"
+#include "systems/KiSystem.hpp"
+
+TEST_CASE("Steering kernels draw the same velocities", "[ki]") {
+	srand(13);
+	for (int round = 0; round < 200; round++)
+	{
+		std::uint64_t bits = (std::uint64_t(rand()) << 32) ^ std::uint64_t(rand());
+		std::uint32_t first = std::uint32_t(rand()) * STEERING_WORD_ENTITIES;
+		std::uint32_t key = util::randomKey(7, round);
+		int expectedX[STEERING_WORD_ENTITIES], expectedY[STEERING_WORD_ENTITIES];
+		std::fill(expectedX, expectedX + STEERING_WORD_ENTITIES, 99);
+		std::fill(expectedY, expectedY + STEERING_WORD_ENTITIES, 99);
+		SteerWordScalar(expectedX, expectedY, bits, first, key, 2);
+
+		std::vector<void (*)(int*, int*, std::uint64_t, std::uint32_t, std::uint32_t, int)> kernels = { SteerWord };
+#ifdef STEERING_SIMD
+		if (__builtin_cpu_supports("sse4.1"))
+		{
+			kernels.push_back(SteerWordSse41);
+		}
+		if (__builtin_cpu_supports("avx2"))
+		{
+			kernels.push_back(SteerWordAvx2);
+		}
+#endif
+		for (auto kernel : kernels)
+		{
+			int velocityX[STEERING_WORD_ENTITIES], velocityY[STEERING_WORD_ENTITIES];
+			std::fill(velocityX, velocityX + STEERING_WORD_ENTITIES, 99);
+			std::fill(velocityY, velocityY + STEERING_WORD_ENTITIES, 99);
+			kernel(velocityX, velocityY, bits, first, key, 2);
+			REQUIRE(std::equal(velocityX, velocityX + STEERING_WORD_ENTITIES, expectedX));
+			REQUIRE(std::equal(velocityY, velocityY + STEERING_WORD_ENTITIES, expectedY));
+		}
+	}
+}
+
+TEST_CASE("Steering does not depend on threads or storage", "[ki]") {
+	Scene single(StorageMode::PerComponent);
+	Scene parallel(StorageMode::PerComponent);
+	Scene tables(StorageMode::Archetype);
+	for (Scene* scene : { &single, &parallel, &tables })
+	{
+		for (int i = 0; i < 3000; i++)
+		{
+			EntityID id = scene->NewEntity();
+			if (i % 5 != 0)
+			{
+				scene->Assign<Velocity>(id);
+			}
+		}
+	}
+
+	ThreadPool pool(3);
+	KiSystem singleKi(nullptr, 42);
+	KiSystem parallelKi(&pool, 42);
+	KiSystem tablesKi(&pool, 42);
+	parallelKi.grain = 256;
+	for (int frame = 0; frame < 5; frame++)
+	{
+		singleKi.update(single, 1);
+		parallelKi.update(parallel, 1);
+		tablesKi.update(tables, 1);
+
+		int directions[3] = {};
+		for (const Entity& entity : single.entities)
+		{
+			if (!entity.mask.test(GetId<Velocity>()))
+			{
+				continue;
+			}
+			Velocity velocity = *single.Get<Velocity>(entity.id);
+			Velocity other = *parallel.Get<Velocity>(entity.id);
+			Velocity table = *tables.Get<Velocity>(entity.id);
+			REQUIRE((velocity.x == other.x && velocity.y == other.y));
+			REQUIRE((velocity.x == table.x && velocity.y == table.y));
+			directions[velocity.x / MOVEMENT_SPEED + 1]++;
+		}
+
+		// Every direction is drawn about equally often
+		for (int count : directions)
+		{
+			REQUIRE(count > 700);
+		}
+	}
+}
@@ -0,0 +1,136 @@
+#include <catch2/catch.hpp>
+
+#include "MovementKernel.hpp"
+#include "World.hpp"
+#include "components/Position.hpp"
+#include "components/Velocity.hpp"
+#include "ecs/Scene.hpp"
+#include "systems/MovementSystem.hpp"
+
+TEST_CASE("Movement kernels match the per axis bounds checks", "[movement]") {
+	World world(50, 40);
+	srand(11);
+	for (int round = 0; round < 200; round++)
+	{
+		int x[MOVEMENT_WORD_ENTITIES], y[MOVEMENT_WORD_ENTITIES], vx[MOVEMENT_WORD_ENTITIES], vy[MOVEMENT_WORD_ENTITIES];
+		std::uint64_t bits = (std::uint64_t(rand()) << 32) ^ std::uint64_t(rand());
+		for (size_t i = 0; i < MOVEMENT_WORD_ENTITIES; i++)
+		{
+			// Also start outside of the world, and cross the borders on both axes
+			x[i] = rand() % 60 - 5;
+			y[i] = rand() % 50 - 5;
+			vx[i] = rand() % 21 - 10;
+			vy[i] = rand() % 21 - 10;
+		}
+
+		int expectedX[MOVEMENT_WORD_ENTITIES], expectedY[MOVEMENT_WORD_ENTITIES];
+		std::uint64_t expectedMoved = 0;
+		for (size_t i = 0; i < MOVEMENT_WORD_ENTITIES; i++)
+		{
+			expectedX[i] = x[i];
+			expectedY[i] = y[i];
+			if ((bits >> i) & 1)
+			{
+				if (world.inWorld(expectedX[i] + vx[i], expectedY[i]))
+				{
+					expectedX[i] += vx[i];
+				}
+				if (world.inWorld(expectedX[i], expectedY[i] + vy[i]))
+				{
+					expectedY[i] += vy[i];
+				}
+			}
+			expectedMoved |= std::uint64_t(expectedX[i] != x[i] || expectedY[i] != y[i]) << i;
+		}
+
+		std::vector<std::uint64_t (*)(int*, int*, const int*, const int*, std::uint64_t, int, int)> kernels = { MoveWordScalar, MoveWord };
+#ifdef MOVEMENT_SIMD
+		if (__builtin_cpu_supports("sse4.1"))
+		{
+			kernels.push_back(MoveWordSse41);
+		}
+		if (__builtin_cpu_supports("avx2"))
+		{
+			kernels.push_back(MoveWordAvx2);
+		}
+#endif
+		for (auto kernel : kernels)
+		{
+			int movedX[MOVEMENT_WORD_ENTITIES], movedY[MOVEMENT_WORD_ENTITIES];
+			std::copy(x, x + MOVEMENT_WORD_ENTITIES, movedX);
+			std::copy(y, y + MOVEMENT_WORD_ENTITIES, movedY);
+			REQUIRE(kernel(movedX, movedY, vx, vy, bits, world.sizeX, world.sizeY) == expectedMoved);
+			REQUIRE(std::equal(movedX, movedX + MOVEMENT_WORD_ENTITIES, expectedX));
+			REQUIRE(std::equal(movedY, movedY + MOVEMENT_WORD_ENTITIES, expectedY));
+		}
+	}
+}
+
+TEST_CASE("Vectorized movement matches movement in archetype storage", "[movement]") {
+	World world(30, 20);
+	Scene columns(StorageMode::PerComponent);
+	Scene tables(StorageMode::Archetype);
+	for (Scene* scene : { &columns, &tables })
+	{
+		srand(12);
+		for (int i = 0; i < 1000; i++)
+		{
+			EntityID id = scene->NewEntity();
+			*scene->Assign<Position>(id) = world.getRandomPos();
+			if (i % 7 != 0)
+			{
+				*scene->Assign<Velocity>(id) = { rand() % 5 - 2, rand() % 5 - 2 };
+			}
+			if (i % 11 == 0)
+			{
+				scene->DestroyEntity(id);
+			}
+		}
+	}
+
+	ThreadPool pool(3);
+	MovementSystem movement(nullptr, &pool);
+	movement.grain = 128;
+	for (int frame = 0; frame < 50; frame++)
+	{
+		movement.update(columns, 1, world);
+		movement.update(tables, 1, world);
+	}
+
+	for (const Entity& entity : columns.entities)
+	{
+		if (IsEntityValid(entity.id))
+		{
+			Position moved = *columns.Get<Position>(entity.id);
+			Position expected = *tables.Get<Position>(entity.id);
+			REQUIRE(moved.x == expected.x);
+			REQUIRE(moved.y == expected.y);
+			REQUIRE(world.inWorld(moved));
+		}
+	}
+}
+
+TEST_CASE("Movement marks only the positions that changed", "[movement]") {
+	World world(30, 20);
+	for (StorageMode mode : { StorageMode::PerComponent, StorageMode::Archetype })
+	{
+		Scene scene(mode);
+		EntityID moving = scene.NewEntity();
+		*scene.Assign<Position>(moving) = Position { 5, 5 };
+		*scene.Assign<Velocity>(moving) = Velocity { 1, 0 };
+		EntityID standing = scene.NewEntity();
+		*scene.Assign<Position>(standing) = Position { 5, 5 };
+		*scene.Assign<Velocity>(standing) = Velocity { 0, 0 };
+		EntityID blocked = scene.NewEntity();
+		*scene.Assign<Position>(blocked) = Position { 29, 5 };
+		*scene.Assign<Velocity>(blocked) = Velocity { 1, 0 };
+
+		// Assigning the components marks them as changed as well
+		REQUIRE(scene.Changed(GetId<Position>())[0] == 7);
+		scene.ClearChanged(GetId<Position>());
+
+		MovementSystem movement;
+		movement.update(scene, 1, world);
+		REQUIRE(scene.Changed(GetId<Position>())[0] == 1);
+	}
+}
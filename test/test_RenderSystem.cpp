@@ -0,0 +1,115 @@
+#include <catch2/catch.hpp>
+
+#include "RenderPipeline.hpp"
+#include "components/Position.hpp"
+#include "components/Sprite.hpp"
+#include "ecs/Scene.hpp"
+#include "systems/RenderSystem.hpp"
+
+TEST_CASE("RenderSystem batches all sprites into one vertex array", "[renderwindow]") {
+	sf::RenderWindow window(sf::VideoMode(200, 200), "RenderSystem");
+	Scene scene;
+	for (int i = 0; i < 3; i++)
+	{
+		EntityID id = scene.NewEntity();
+		*scene.Assign<Position>(id) = Position { 10 * i, 20 };
+		auto sprite = scene.Assign<Sprite>(id);
+		sprite->color = sf::Color::Red;
+	}
+	scene.Assign<Position>(scene.NewEntity());
+
+	RenderSystem renderSystem;
+	window.clear();
+	renderSystem.update(scene, 0, window);
+	window.display();
+
+	// One quad per entity slot, covering the bounds of its circle. The entity without sprite has an empty quad
+	REQUIRE(renderSystem.vertices.getVertexCount() == 16);
+	REQUIRE(renderSystem.vertices[4].position == sf::Vector2f(10, 20));
+	REQUIRE(renderSystem.vertices[6].position == sf::Vector2f(12, 22));
+	REQUIRE(renderSystem.vertices[11].color == sf::Color::Red);
+	REQUIRE(renderSystem.vertices[12].position == renderSystem.vertices[14].position);
+}
+
+TEST_CASE("RenderSystem only captures entities that changed after the first frame", "[renderwindow]") {
+	sf::RenderWindow window(sf::VideoMode(200, 200), "RenderSystem");
+	Scene scene;
+	std::vector<EntityID> ids;
+	for (int i = 0; i < 100; i++)
+	{
+		ids.push_back(scene.NewEntity());
+		*scene.Assign<Position>(ids.back()) = Position { i, i };
+		scene.Assign<Sprite>(ids.back());
+	}
+
+	RenderSystem renderSystem;
+	RenderSnapshot snapshot;
+	renderSystem.capture(scene, snapshot);
+	REQUIRE(snapshot.sprites.size() == 100);
+	renderSystem.draw(snapshot, window);
+
+	renderSystem.capture(scene, snapshot);
+	REQUIRE(snapshot.sprites.empty());
+	REQUIRE(snapshot.slots == 100);
+
+	// Moved and destroyed entities are captured, the destroyed one with an empty sprite
+	scene.GetUnchecked<Position>(ids[70])->x = 5;
+	scene.MarkChanged(GetId<Position>(), GetEntityIndex(ids[70]));
+	scene.DestroyEntity(ids[3]);
+	renderSystem.capture(scene, snapshot);
+	REQUIRE(snapshot.sprites.size() == 2);
+	REQUIRE(snapshot.sprites[0].slot == 3);
+	REQUIRE(snapshot.sprites[0].sprite.radius == 0);
+	REQUIRE(snapshot.sprites[1].slot == 70);
+	REQUIRE(snapshot.sprites[1].x == 5.0f);
+
+	renderSystem.draw(snapshot, window);
+	REQUIRE(renderSystem.vertices[70 * 4].position == sf::Vector2f(5, 70));
+	REQUIRE(renderSystem.vertices[3 * 4].position == renderSystem.vertices[3 * 4 + 2].position);
+	REQUIRE(renderSystem.vertices[71 * 4].position == sf::Vector2f(71, 71));
+}
+
+TEST_CASE("RenderSystem draws unbatched sprites with their shared shape", "[renderwindow]") {
+	sf::RenderWindow window(sf::VideoMode(200, 200), "RenderSystem");
+	Scene scene;
+	EntityID id = scene.NewEntity();
+	*scene.Assign<Position>(id) = Position { 30, 40 };
+	auto sprite = scene.Assign<Sprite>(id);
+	sprite->radius = 3;
+
+	RenderSystem renderSystem;
+	renderSystem.batched = false;
+	renderSystem.shapes.push_back(sf::CircleShape(1, 4));
+	sprite->shape = 1;
+	window.clear();
+	renderSystem.update(scene, 0, window);
+	window.display();
+
+	REQUIRE(renderSystem.shapes[1].getRadius() == 3.0f);
+	REQUIRE(renderSystem.shapes[1].getPosition() == sf::Vector2f(30, 40));
+	REQUIRE(renderSystem.shapes[1].getFillColor() == sf::Color::White);
+}
+
+TEST_CASE("Render pipeline never hands out the frame it draws", "[renderwindow]") {
+	sf::RenderWindow window(sf::VideoMode(200, 200), "RenderPipeline");
+	RenderSystem renderSystem;
+	RenderPipeline pipeline(window, renderSystem);
+	for (int frame = 0; frame < 200; frame++)
+	{
+		RenderPipeline::Frame& back = pipeline.Back();
+		back.snapshot.slots = 7;
+		back.snapshot.sprites.clear();
+		for (EntityIndex slot = 0; slot < EntityIndex(frame % 7); slot++)
+		{
+			back.snapshot.sprites.push_back(SpriteSnapshot { float(frame), 0, Sprite(), slot });
+		}
+		pipeline.Publish();
+
+		std::lock_guard<std::mutex> lock(pipeline.mutex);
+		REQUIRE(pipeline.drawing != pipeline.back);
+	}
+	pipeline.Stop();
+
+	// Every frame holds changes, so none of them is skipped
+	REQUIRE(pipeline.drawn == 200);
+}
@@ -0,0 +1,406 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+
+#include "components/Collision.hpp"
+#include "components/Health.hpp"
+#include "components/Position.hpp"
+#include "ecs/Query.hpp"
+#include "ecs/Scene.hpp"
+#include "ecs/SceneView.hpp"
+
+TEST_CASE("Scene pools address components by entity index", "[scene]") {
+	Scene scene;
+	std::vector<EntityID> ids;
+	for (int i = 0; i < 10; i++)
+	{
+		EntityID id = scene.NewEntity();
+		scene.Assign<Position>(id)->x = i;
+		ids.push_back(id);
+	}
+
+	for (int i = 0; i < 10; i++)
+	{
+		REQUIRE(scene.Get<Position>(ids[i])->x == i);
+	}
+	REQUIRE(scene.Get<Health>(ids[0]) == nullptr);
+}
+
+TEST_CASE("TryGet rejects destroyed entities", "[scene]") {
+	Scene scene;
+	EntityID id = scene.NewEntity();
+	scene.Assign<Position>(id)->x = 1;
+	REQUIRE(scene.TryGet<Position>(id) == scene.GetUnchecked<Position>(id));
+
+	scene.DestroyEntity(id);
+	EntityID reused = scene.NewEntity();
+	scene.Assign<Position>(reused)->x = 2;
+
+	REQUIRE(GetEntityIndex(reused) == GetEntityIndex(id));
+	REQUIRE(scene.TryGet<Position>(id) == nullptr);
+	REQUIRE(scene.TryGet<Position>(reused)->x == 2);
+	REQUIRE(scene.TryGet<Health>(reused) == nullptr);
+}
+
+TEST_CASE("Scene pools grow in chunks without moving components", "[scene]") {
+	SceneConfig config;
+	config.capacity = 4;
+	config.chunkSize = 4;
+	Scene scene(config);
+
+	EntityID first = scene.NewEntity();
+	ComponentPtr<Position> position = scene.Assign<Position>(first);
+	position->x = 42;
+	for (int i = 0; i < 1000; i++)
+	{
+		scene.Assign<Position>(scene.NewEntity())->x = i;
+	}
+
+	REQUIRE(scene.Get<Position>(first) == position);
+	REQUIRE(position->x == 42);
+	REQUIRE(scene.soaPools[GetId<Position>()]->ChunkCount() == 251);
+}
+
+TEST_CASE("Sparse sets stay packed when components are removed", "[scene][sparseset]") {
+	Scene scene;
+	std::vector<EntityID> ids;
+	for (int i = 0; i < 10; i++)
+	{
+		EntityID id = scene.NewEntity();
+		scene.Assign<Health>(id)->health = i;
+		scene.Assign<Collision>(id)->damage = i;
+		ids.push_back(id);
+	}
+
+	scene.Remove<Collision>(ids[2]);
+	scene.DestroyEntity(ids[5]);
+
+	REQUIRE(scene.GetSparseSet<Collision>()->Size() == 8);
+	REQUIRE(scene.Get<Collision>(ids[2]) == nullptr);
+	REQUIRE(scene.Get<Collision>(ids[9])->damage == 9);
+
+	// Removing the current component while iterating visits every entity exactly once
+	int visited = 0;
+	for (EntityID id : SceneView<Health, Collision>(scene))
+	{
+		REQUIRE(scene.Get<Collision>(id)->damage == scene.Get<Health>(id)->health);
+		scene.Remove<Collision>(id);
+		visited++;
+	}
+	REQUIRE(visited == 8);
+	REQUIRE(scene.GetSparseSet<Collision>()->Size() == 0);
+}
+
+TEST_CASE("Archetype storage moves entities between tables", "[scene][archetype]") {
+	Scene scene(StorageMode::Archetype);
+	std::vector<EntityID> ids;
+	for (int i = 0; i < 10; i++)
+	{
+		EntityID id = scene.NewEntity();
+		scene.Assign<Position>(id)->x = i;
+		scene.Assign<Health>(id)->health = i;
+		ids.push_back(id);
+	}
+	scene.Assign<Collision>(ids[3])->damage = 3;
+	scene.Remove<Health>(ids[4]);
+	scene.DestroyEntity(ids[5]);
+
+	REQUIRE(scene.Get<Position>(ids[3])->x == 3);
+	REQUIRE(scene.Get<Collision>(ids[3])->damage == 3);
+	REQUIRE(scene.Get<Health>(ids[4]) == nullptr);
+	REQUIRE(scene.Get<Position>(ids[9])->x == 9);
+
+	int visited = 0;
+	SceneView<Position, Health>(scene).ForEach([&](EntityID id, ComponentRef<Position> position, Health& health) {
+		REQUIRE(position.x == health.health);
+		visited++;
+	});
+	REQUIRE(visited == 8);
+
+	visited = 0;
+	for (EntityID id : SceneView<Position>(scene))
+	{
+		REQUIRE(scene.Get<Position>(id)->x == int(GetEntityIndex(id)));
+		visited++;
+	}
+	REQUIRE(visited == 9);
+}
+
+
+TEST_CASE("ParallelForEach visits every entity once", "[scene][parallel]") {
+	ThreadPool pool(3);
+	StorageMode mode = GENERATE(StorageMode::PerComponent, StorageMode::Archetype);
+	Scene scene(mode);
+	for (int i = 0; i < 5000; i++)
+	{
+		EntityID id = scene.NewEntity();
+		scene.Assign<Position>(id)->x = 0;
+		if (i % 3 == 0)
+		{
+			scene.Assign<Health>(id);
+		}
+		if (i % 2 == 0)
+		{
+			scene.Assign<Collision>(id);
+		}
+	}
+
+	SceneView<Position>(scene).ParallelForEach(pool, [](EntityID id, ComponentRef<Position> position) { position.x++; }, 100);
+	SceneView<Position, Health>(scene).ParallelForEach(pool, [](EntityID id, ComponentRef<Position> position, Health& health) { position.x += 10; }, 100);
+	SceneView<Position, Collision>(scene).ParallelForEach(pool, [](EntityID id, ComponentRef<Position> position, Collision& collision) { position.x += 100; }, 100);
+
+	for (EntityID id : SceneView<Position>(scene))
+	{
+		EntityIndex index = GetEntityIndex(id);
+		REQUIRE(scene.Get<Position>(id)->x == 1 + (index % 3 == 0 ? 10 : 0) + (index % 2 == 0 ? 100 : 0));
+	}
+}
+
+TEST_CASE("Command buffers apply structural changes at playback", "[scene][commands]") {
+	StorageMode mode = GENERATE(StorageMode::PerComponent, StorageMode::Archetype);
+	Scene scene(mode);
+	ThreadPool pool(3);
+	for (int i = 0; i < 1000; i++)
+	{
+		EntityID id = scene.NewEntity();
+		scene.Assign<Health>(id)->health = i;
+	}
+
+	// Record from all threads while iterating
+	scene.ReserveCommandBuffers(ThreadPool::SlotCount(&pool));
+	SceneView<Health>(scene).ParallelForEach(pool, [&](EntityID id, Health& health) {
+		if (health.health % 2 == 0)
+		{
+			scene.Commands().Assign<Collision>(id, { health.health });
+		}
+		if (health.health % 5 == 0)
+		{
+			scene.Commands().Destroy(id);
+			scene.Commands().Assign<Position>(id, { 1, 1 });
+		}
+	}, 64);
+	scene.Commands().Create([](Scene& scene, EntityID id) { scene.Assign<Health>(id)->health = -1; });
+
+	REQUIRE(SceneView<Collision>(scene).begin() == SceneView<Collision>(scene).end());
+	scene.Playback();
+
+	int collisions = 0;
+	for (EntityID id : SceneView<Collision>(scene))
+	{
+		REQUIRE(scene.Get<Collision>(id)->damage == scene.Get<Health>(id)->health);
+		collisions++;
+	}
+	REQUIRE(collisions == 400);
+	REQUIRE(SceneView<Position>(scene).begin() == SceneView<Position>(scene).end());
+
+	// The new entity reuses the index of a destroyed one
+	int created = 0;
+	for (EntityID id : SceneView<Health>(scene))
+	{
+		if (scene.Get<Health>(id)->health == -1)
+		{
+			REQUIRE(GetEntityIndex(id) < 1000);
+			created++;
+		}
+	}
+	REQUIRE(created == 1);
+}
+
+TEST_CASE("Membership bitmaps match the component masks", "[scene][bitmap]") {
+	Scene scene;
+	srand(3);
+	for (int i = 0; i < 3000; i++)
+	{
+		EntityID id = scene.NewEntity();
+		if (rand() % 4 == 0)
+		{
+			scene.Assign<Position>(id);
+		}
+		if (rand() % 50 == 0)
+		{
+			scene.Assign<Health>(id);
+		}
+	}
+	for (int i = 0; i < 500; i++)
+	{
+		EntityID id = scene.entities[rand() % scene.entities.size()].id;
+		if (IsEntityValid(id))
+		{
+			rand() % 2 == 0 ? scene.DestroyEntity(id) : scene.Remove<Position>(id);
+		}
+	}
+
+	// Compare the views with a scan over all entities, also starting in the middle of a block
+	for (EntityIndex start : { 0u, 70u, 1500u })
+	{
+		std::vector<EntityID> expected;
+		for (EntityIndex index = start; index < scene.entities.size(); index++)
+		{
+			const Entity& entity = scene.entities[index];
+			if (IsEntityValid(entity.id) && entity.mask.test(GetId<Position>()) && entity.mask.test(GetId<Health>()))
+			{
+				expected.push_back(entity.id);
+			}
+		}
+		std::vector<EntityID> visited;
+		for (EntityID id : SceneView<Position, Health>(scene, start))
+		{
+			visited.push_back(id);
+		}
+		REQUIRE(!expected.empty());
+		REQUIRE(visited == expected);
+	}
+
+	// The SIMD search has to agree with the scalar one
+	const std::uint64_t* bitmaps[] = { scene.Membership(GetId<Position>()), scene.Membership(GetId<Health>()) };
+	for (size_t word = 0; word < scene.membershipWords; word += BITMAP_BLOCK_WORDS)
+	{
+		REQUIRE(AnyInBlock(bitmaps, 2, word) == AnyInBlockScalar(bitmaps, 2, word));
+	}
+}
+
+TEST_CASE("Structure of arrays components store each field contiguously", "[scene][soa]") {
+	StorageMode mode = GENERATE(StorageMode::PerComponent, StorageMode::Archetype);
+	Scene scene(mode);
+	std::vector<EntityID> ids;
+	for (int i = 0; i < 100; i++)
+	{
+		EntityID id = scene.NewEntity();
+		*scene.Assign<Position>(id) = { i, -i };
+		ids.push_back(id);
+	}
+	scene.Commands().Assign<Position>(ids[7], { 70, 71 });
+	scene.Playback();
+
+	SceneView<Position>(scene).ForEach([](EntityID id, ComponentRef<Position> position) { position.y *= 2; });
+	for (int i = 0; i < 100; i++)
+	{
+		Position position = *scene.Get<Position>(ids[i]);
+		REQUIRE(position.x == (i == 7 ? 70 : i));
+		REQUIRE(position.y == (i == 7 ? 142 : -2 * i));
+	}
+
+	if (mode == StorageMode::PerComponent)
+	{
+		// Neighbouring entities have neighbouring values, field by field
+		SoaPool<Position>* pool = scene.GetSoaPool<Position>();
+		REQUIRE(&scene.Get<Position>(ids[1])->x == &scene.Get<Position>(ids[0])->x + 1);
+		REQUIRE(&scene.Get<Position>(ids[1])->y == &scene.Get<Position>(ids[0])->y + 1);
+		REQUIRE(pool->Column<0>(0)[GetEntityIndex(ids[42])] == 42);
+		REQUIRE(pool->Column<1>(0)[GetEntityIndex(ids[42])] == -84);
+	}
+}
+
+TEST_CASE("Cached queries follow assigned and removed components", "[scene][query]") {
+	StorageMode mode = GENERATE(StorageMode::PerComponent, StorageMode::Archetype);
+	Scene scene(mode);
+	srand(5);
+	for (int i = 0; i < 200; i++)
+	{
+		scene.Assign<Position>(scene.NewEntity());
+	}
+	Query<Position, Health> query(scene);
+	REQUIRE(query.Size() == 0);
+
+	for (int step = 0; step < 2000; step++)
+	{
+		EntityID id = scene.entities[rand() % scene.entities.size()].id;
+		int action = rand() % 5;
+		if (action == 0)
+		{
+			scene.Assign<Position>(scene.NewEntity());
+		}
+		else if (action == 1 && IsEntityValid(id))
+		{
+			scene.DestroyEntity(id);
+		}
+		else if (action == 2 && IsEntityValid(id))
+		{
+			scene.Remove<Health>(id);
+		}
+		else if (IsEntityValid(id))
+		{
+			scene.Assign<Health>(id);
+		}
+
+		// The query holds exactly the entities that a view finds
+		std::set<EntityID> expected;
+		for (EntityID match : SceneView<Position, Health>(scene))
+		{
+			expected.insert(match);
+		}
+		REQUIRE(std::set<EntityID>(query.begin(), query.end()) == expected);
+		REQUIRE(query.Size() == expected.size());
+	}
+
+	int visited = 0;
+	query.ForEach([&](EntityID id, ComponentRef<Position> position, Health& health) {
+		scene.Remove<Health>(id);
+		visited++;
+	});
+	REQUIRE(visited > 0);
+	REQUIRE(query.Size() == 0);
+}
+
+TEST_CASE("Component lookup cost", "[.][benchmark]") {
+	Scene scene;
+	std::vector<EntityID> ids;
+	for (int i = 0; i < 100000; i++)
+	{
+		EntityID id = scene.NewEntity();
+		scene.Assign<Position>(id)->x = i;
+		ids.push_back(id);
+	}
+
+	BENCHMARK("Get")
+	{
+		int sum = 0;
+		for (EntityID id : ids)
+		{
+			sum += scene.Get<Position>(id)->x;
+		}
+		return sum;
+	};
+
+	BENCHMARK("TryGet")
+	{
+		int sum = 0;
+		for (EntityID id : ids)
+		{
+			sum += scene.TryGet<Position>(id)->x;
+		}
+		return sum;
+	};
+
+	BENCHMARK("GetUnchecked")
+	{
+		int sum = 0;
+		for (EntityID id : ids)
+		{
+			sum += scene.GetUnchecked<Position>(id)->x;
+		}
+		return sum;
+	};
+}
+TEST_CASE("Scene counts the entities with components", "[scene]") {
+	for (StorageMode mode : { StorageMode::PerComponent, StorageMode::Archetype })
+	{
+		Scene scene(mode);
+		REQUIRE(scene.Count<Position>() == 0);
+		for (int i = 0; i < 300; i++)
+		{
+			EntityID id = scene.NewEntity();
+			scene.Assign<Position>(id);
+			if (i % 3 == 0)
+			{
+				scene.Assign<Health>(id);
+			}
+			if (i % 2 == 0)
+			{
+				scene.DestroyEntity(id);
+			}
+		}
+		REQUIRE(scene.Count<Position>() == 150);
+		REQUIRE(scene.Count<Health>() == 50);
+		REQUIRE(scene.Count<Position, Health>() == 50);
+	}
+}
@@ -0,0 +1,263 @@
+#include <catch2/catch.hpp>
+
+#include "Simulation.hpp"
+#include "components/Collision.hpp"
+#include "components/Health.hpp"
+#include "components/Position.hpp"
+#include "ecs/Query.hpp"
+#include "ecs/Scene.hpp"
+#include "ecs/SceneSnapshot.hpp"
+#include <cstddef>
+#include <fstream>
+
+/**
+ * @brief Fill a scene with entities in several chunks, some of them destroyed and some without all components
+ *
+ * @param scene Scene that is filled
+ * @return std::vector<EntityID> IDs of the entities that are alive
+ */
+static std::vector<EntityID> FillScene(Scene& scene)
+{
+	std::vector<EntityID> ids;
+	for (int i = 0; i < 300; i++)
+	{
+		EntityID id = scene.NewEntity();
+		*scene.Assign<Position>(id) = Position { i, 2 * i };
+		if (i % 3 == 0)
+		{
+			scene.Assign<Health>(id)->health = i;
+		}
+		if (i % 5 == 0)
+		{
+			scene.Assign<Collision>(id)->damage = i + 1;
+		}
+		ids.push_back(id);
+	}
+
+	// Destroyed after all entities were created, so their indices stay free
+	std::vector<EntityID> alive;
+	for (size_t i = 0; i < ids.size(); i++)
+	{
+		if (i % 7 == 0)
+		{
+			scene.DestroyEntity(ids[i]);
+		}
+		else
+		{
+			alive.push_back(ids[i]);
+		}
+	}
+	return alive;
+}
+
+TEST_CASE("Scene snapshots restore entities and components", "[snapshot]") {
+	std::string path = (util::fs::temp_directory_path() / "test_SceneSnapshot.snapshot").string();
+	SceneConfig config;
+	config.chunkSize = 64;
+	Scene saved(config);
+	std::vector<EntityID> ids = FillScene(saved);
+	REQUIRE(SceneSnapshot::Save<Position, Health, Collision>(saved, path));
+
+	Scene loaded;
+	Query<Health> query(loaded);
+	REQUIRE(SceneSnapshot::Load<Position, Health, Collision>(loaded, path));
+	REQUIRE(loaded.entities.size() == saved.entities.size());
+	REQUIRE(loaded.freeEntities == saved.freeEntities);
+	REQUIRE(loaded.Count<Position>() == saved.Count<Position>());
+	REQUIRE(loaded.Count<Health, Collision>() == saved.Count<Health, Collision>());
+	REQUIRE(std::distance(query.begin(), query.end()) == loaded.Count<Health>());
+	for (EntityID id : ids)
+	{
+		REQUIRE(loaded.TryGet<Position>(id)->y == saved.Get<Position>(id)->y);
+		REQUIRE((loaded.TryGet<Health>(id) == nullptr) == (saved.Get<Health>(id) == nullptr));
+		REQUIRE((loaded.TryGet<Collision>(id) == nullptr) == (saved.Get<Collision>(id) == nullptr));
+		if (saved.Get<Collision>(id) != nullptr)
+		{
+			REQUIRE(loaded.Get<Collision>(id)->damage == saved.Get<Collision>(id)->damage);
+		}
+	}
+
+	// The pools use the chunks of the mapped file in place
+	ComponentPool* xs = loaded.GetSoaPool<Position>()->fields[0];
+	REQUIRE(xs->borrowed == 5);
+	REQUIRE(xs->chunks[0] >= loaded.mapping.data());
+	REQUIRE(xs->chunks[0] < loaded.mapping.data() + loaded.mapping.size());
+
+	// The loaded scene can be changed and grown, without changing the file
+	loaded.Get<Position>(ids[0])->x = -1;
+	EntityID reused = loaded.NewEntity();
+	REQUIRE(GetEntityIndex(reused) == saved.freeEntities.back());
+	for (int i = 0; i < 100; i++)
+	{
+		loaded.Assign<Health>(loaded.NewEntity())->health = 7;
+	}
+	REQUIRE(loaded.Get<Health>(loaded.entities.back().id)->health == 7);
+
+	Scene reloaded;
+	REQUIRE(SceneSnapshot::Load<Position, Health, Collision>(reloaded, path));
+	REQUIRE(reloaded.Get<Position>(ids[0])->x == saved.Get<Position>(ids[0])->x);
+	util::fs::remove(path);
+}
+
+TEST_CASE("Scene snapshots skip the component types that are not loaded", "[snapshot]") {
+	std::string path = (util::fs::temp_directory_path() / "test_SceneSnapshot_skip.snapshot").string();
+	Scene saved;
+	std::vector<EntityID> ids = FillScene(saved);
+	REQUIRE(SceneSnapshot::Save<Position, Health, Collision>(saved, path));
+
+	Scene loaded;
+	REQUIRE(SceneSnapshot::Load<Position>(loaded, path));
+	REQUIRE(loaded.Count<Position>() == ids.size());
+	for (EntityID id : ids)
+	{
+		REQUIRE(loaded.entities[GetEntityIndex(id)].mask == MaskOf<Position>());
+		REQUIRE(loaded.Get<Health>(id) == nullptr);
+	}
+	util::fs::remove(path);
+}
+
+/**
+ * @brief Overwrite a value in a snapshot file
+ *
+ * @tparam T Type of the value
+ * @param path Path of the file
+ * @param offset Offset of the value in the file
+ * @param value Value that is written
+ */
+template <typename T>
+static void Patch(const std::string& path, std::uint64_t offset, T value)
+{
+	std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+	file.seekp(std::streamoff(offset));
+	file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * @brief Read a value from a snapshot file
+ *
+ * @tparam T Type of the value
+ * @param path Path of the file
+ * @param offset Offset of the value in the file
+ * @return T Value at the offset
+ */
+template <typename T>
+static T Peek(const std::string& path, std::uint64_t offset)
+{
+	T value;
+	std::ifstream file(path, std::ios::binary);
+	file.seekg(std::streamoff(offset));
+	file.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return value;
+}
+
+TEST_CASE("Scene snapshots are only loaded into empty scenes from valid files", "[snapshot]") {
+	std::string path = (util::fs::temp_directory_path() / "test_SceneSnapshot_invalid.snapshot").string();
+	Scene saved;
+	FillScene(saved);
+	REQUIRE(SceneSnapshot::Save<Position, Health>(saved, path));
+
+	Scene full;
+	full.NewEntity();
+	REQUIRE_FALSE(SceneSnapshot::Load<Position, Health>(full, path));
+	REQUIRE(full.entities.size() == 1);
+
+	// A truncated file is rejected before the scene is changed
+	util::fs::resize_file(path, util::fs::file_size(path) / 2);
+	Scene truncated;
+	REQUIRE_FALSE(SceneSnapshot::Load<Position, Health>(truncated, path));
+	REQUIRE(truncated.entities.empty());
+	REQUIRE(truncated.mapping.data() == nullptr);
+
+	Scene missing;
+	util::fs::remove(path);
+	REQUIRE_FALSE(SceneSnapshot::Load<Position, Health>(missing, path));
+
+	Scene tables(StorageMode::Archetype);
+	REQUIRE_FALSE(SceneSnapshot::Save<Position>(tables, path));
+}
+
+TEST_CASE("Scene snapshots can be saved over the file they were loaded from", "[snapshot]") {
+	std::string path = (util::fs::temp_directory_path() / "test_SceneSnapshot_resave.snapshot").string();
+	SceneConfig config;
+	config.capacity = 3000;
+	Simulation first(World(200, 200), config);
+	for (int i = 0; i < 3000; i++)
+	{
+		first.Spawn();
+	}
+	REQUIRE(first.Save(path));
+
+	// Same flow as the headless runner: restore, run, save back to the file that is still mapped
+	Simulation second(World(200, 200), config);
+	REQUIRE(second.Load(path));
+	for (int tick = 0; tick < 5; tick++)
+	{
+		second.Tick(1);
+	}
+	REQUIRE(second.Save(path));
+
+	Simulation third(World(200, 200), config);
+	REQUIRE(third.Load(path));
+	REQUIRE(third.scene.entities.size() == second.scene.entities.size());
+	REQUIRE(third.scene.freeEntities == second.scene.freeEntities);
+	for (const Entity& entity : second.scene.entities)
+	{
+		if (!IsEntityValid(entity.id))
+		{
+			continue;
+		}
+		REQUIRE(third.scene.entities[GetEntityIndex(entity.id)].mask == entity.mask);
+		REQUIRE(third.scene.Get<Position>(entity.id)->x == second.scene.Get<Position>(entity.id)->x);
+		REQUIRE(third.scene.Get<Position>(entity.id)->y == second.scene.Get<Position>(entity.id)->y);
+		REQUIRE(third.scene.Get<Velocity>(entity.id)->x == second.scene.Get<Velocity>(entity.id)->x);
+		REQUIRE(third.scene.Get<Health>(entity.id)->health == second.scene.Get<Health>(entity.id)->health);
+	}
+	REQUIRE_FALSE(util::fs::exists(path + ".tmp"));
+	util::fs::remove(path);
+}
+
+TEST_CASE("Scene snapshots reject entity indices outside of the entity table", "[snapshot]") {
+	std::string path = (util::fs::temp_directory_path() / "test_SceneSnapshot_indices.snapshot").string();
+	Scene saved;
+	FillScene(saved);
+	REQUIRE(SceneSnapshot::Save<Position, Collision>(saved, path));
+	SceneSnapshot::Header header = Peek<SceneSnapshot::Header>(path, 0);
+	SceneSnapshot::Component collision {};
+	std::uint64_t collisionOffset = 0;
+	for (std::uint32_t i = 0; i < header.componentCount; i++)
+	{
+		std::uint64_t offset = sizeof(header) + i * sizeof(SceneSnapshot::Component);
+		SceneSnapshot::Component entry = Peek<SceneSnapshot::Component>(path, offset);
+		if (entry.storage == std::uint32_t(StorageType::SparseSet))
+		{
+			collision = entry;
+			collisionOffset = offset;
+		}
+	}
+	REQUIRE(collision.denseCount == saved.Count<Collision>());
+
+	SECTION("free index") {
+		REQUIRE(header.freeCount > 0);
+		Patch(path, header.freeOffset, EntityIndex(header.entityCount + 1000));
+	}
+	SECTION("free index of an entity that is alive") {
+		Patch(path, header.freeOffset, EntityIndex(1));
+	}
+	SECTION("dense entity index") {
+		Patch(path, collision.denseEntitiesOffset, CreateEntityId(EntityIndex(header.entityCount + 1000), 0));
+	}
+	SECTION("dense entity listed twice") {
+		Patch(path, collision.denseEntitiesOffset + sizeof(EntityID), Peek<EntityID>(path, collision.denseEntitiesOffset));
+	}
+	SECTION("dense count") {
+		Patch(path, collisionOffset + offsetof(SceneSnapshot::Component, denseCount), collision.denseCount - 1);
+	}
+	SECTION("entity count that overflows the column sizes") {
+		Patch(path, offsetof(SceneSnapshot::Header, entityCount), std::uint64_t(1) << 62);
+	}
+
+	Scene loaded;
+	REQUIRE_FALSE(SceneSnapshot::Load<Position, Collision>(loaded, path));
+	REQUIRE(loaded.entities.empty());
+	util::fs::remove(path);
+}
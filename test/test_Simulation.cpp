@@ -0,0 +1,61 @@
+#include <catch2/catch.hpp>
+
+#include "FixedTimestep.hpp"
+#include "Simulation.hpp"
+
+TEST_CASE("Fixed timestep hands out whole ticks and keeps the rest", "[simulation]") {
+	FixedTimestep timestep(100, 3);
+	REQUIRE(timestep.TickTime() == 10.0f);
+	REQUIRE(timestep.Advance(9999) == 0);
+	REQUIRE(timestep.Advance(1) == 1);
+	REQUIRE(timestep.Advance(25000) == 2);
+	REQUIRE(timestep.accumulator == 5000);
+
+	// A long stall only runs the budget, the fraction of the next tick is kept
+	REQUIRE(timestep.Advance(1000000) == 3);
+	REQUIRE(timestep.dropped == 97);
+	REQUIRE(timestep.accumulator == 5000);
+	REQUIRE(timestep.ticks == 6);
+}
+
+TEST_CASE("Simulations with the same seed end in the same state", "[simulation]") {
+	SceneConfig config;
+	config.capacity = 3000;
+	World world(200, 200);
+
+	std::vector<std::vector<int>> states;
+	for (int run = 0; run < 2; run++)
+	{
+		srand(21);
+		Simulation simulation(world, config, CollisionMode::Incremental, 5);
+		for (size_t i = 0; i < config.capacity; i++)
+		{
+			simulation.Spawn();
+		}
+
+		// Both runs see frames of different length, but run the same ticks
+		FixedTimestep timestep(60);
+		std::int64_t frame = run == 0 ? 16667 : 33334;
+		while (simulation.ticks < 40)
+		{
+			for (unsigned int ticks = timestep.Advance(frame); ticks > 0 && simulation.ticks < 40; ticks--)
+			{
+				simulation.Tick(timestep.TickTime());
+			}
+		}
+
+		std::vector<int> state;
+		for (const Entity& entity : simulation.scene.entities)
+		{
+			if (IsEntityValid(entity.id))
+			{
+				Position position = *simulation.scene.Get<Position>(entity.id);
+				state.insert(state.end(), { int(GetEntityIndex(entity.id)), position.x, position.y, simulation.scene.Get<Health>(entity.id)->health });
+			}
+		}
+		states.push_back(state);
+	}
+
+	REQUIRE(!states[0].empty());
+	REQUIRE(states[0] == states[1]);
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch.hpp>
+
+#include "Profiler.hpp"
+#include "components/Health.hpp"
+#include "components/Position.hpp"
+#include "components/Velocity.hpp"
+#include "ecs/SystemScheduler.hpp"
+#include "ecs/ThreadPool.hpp"
+#include <chrono>
+
+TEST_CASE("Scheduler keeps the order of conflicting systems", "[scheduler]") {
+	ThreadPool pool(3);
+	SystemScheduler scheduler(pool);
+	std::mutex mutex;
+	std::vector<std::string> order;
+	auto record = [&](const std::string& name) {
+		return [&, name] {
+			std::lock_guard<std::mutex> lock(mutex);
+			order.push_back(name);
+		};
+	};
+
+	scheduler.Add("Ki", { ComponentMask(), MaskOf<Velocity>() }, record("Ki"));
+	scheduler.Add("Movement", { MaskOf<Velocity>(), MaskOf<Position>() }, record("Movement"));
+	scheduler.Add("Render", { MaskOf<Position>(), ComponentMask() }, record("Render"));
+	scheduler.Add("Damage", { ComponentMask(), MaskOf<Health>() }, record("Damage"));
+	SystemAccess structural;
+	structural.structural = true;
+	scheduler.Add("Health", structural, record("Health"));
+
+	for (int frame = 0; frame < 100; frame++)
+	{
+		order.clear();
+		scheduler.Run();
+
+		REQUIRE(order.size() == 5);
+		auto at = [&](const std::string& name) {
+			return std::find(order.begin(), order.end(), name) - order.begin();
+		};
+		REQUIRE(at("Ki") < at("Movement"));
+		REQUIRE(at("Movement") < at("Render"));
+		REQUIRE(order.back() == "Health");
+	}
+}
+
+TEST_CASE("Scheduler runs independent systems at the same time", "[scheduler]") {
+	ThreadPool pool(1);
+	SystemScheduler scheduler(pool);
+	std::atomic<int> started { 0 };
+	std::atomic<int> overlapped { 0 };
+	std::thread::id renderThread;
+
+	// Each system waits a while for the other one to start
+	auto wait = [&] {
+		started++;
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (started < 2 && std::chrono::steady_clock::now() < deadline)
+		{
+			std::this_thread::yield();
+		}
+		overlapped += started == 2;
+	};
+	scheduler.Add("Ki", { ComponentMask(), MaskOf<Velocity>() }, wait);
+	SystemAccess render { MaskOf<Position>(), ComponentMask() };
+	render.mainThread = true;
+	scheduler.Add("Render", render, [&] {
+		renderThread = std::this_thread::get_id();
+		wait();
+	});
+
+	scheduler.Run();
+
+	REQUIRE(overlapped == 2);
+	REQUIRE(renderThread == std::this_thread::get_id());
+}
+TEST_CASE("Profiled scheduler records every system with its entities", "[scheduler][profiler]") {
+	ThreadPool pool(2);
+	SystemScheduler scheduler(pool);
+	Profiler profiler(4);
+	scheduler.Add("Ki", { ComponentMask(), MaskOf<Velocity>() }, [] {}, [] { return size_t(7); });
+	scheduler.Profile(&profiler);
+	scheduler.Add("Render", { MaskOf<Position>(), ComponentMask() }, [] { std::this_thread::sleep_for(std::chrono::milliseconds(2)); });
+
+	for (int frame = 0; frame < 6; frame++)
+	{
+		scheduler.Run();
+	}
+
+	REQUIRE(profiler.sections.size() == 2);
+	REQUIRE(profiler.sections[0].name == "Ki");
+	REQUIRE(profiler.sections[0].entities == 7);
+	REQUIRE(profiler.sections[1].entities == 0);
+	REQUIRE(profiler.sections[1].samples == 6);
+	REQUIRE(profiler.sections[1].times.size() == 4);
+	REQUIRE(profiler.sections[1].Min() >= 2.0f);
+
+	// The statistics only cover the last frames of the window
+	ProfileSection& section = profiler.sections[0];
+	for (float time : { 100.0f, 1.0f, 2.0f, 3.0f, 4.0f })
+	{
+		profiler.Record(0, time, 7);
+	}
+	REQUIRE(section.Min() == 1.0f);
+	REQUIRE(section.Average() == 2.5f);
+	REQUIRE(section.Percentile(0.99f) == 4.0f);
+	REQUIRE(section.Percentile(0.0f) == 1.0f);
+}